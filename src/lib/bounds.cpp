@@ -0,0 +1,122 @@
+#include "bounds.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+namespace {
+    // Per-thread arrays indexed by vertex, reused across calls. An entry counts only while its
+    // stamp is current, so a call neither clears nor allocates numVertices-sized memory.
+    struct Scratch {
+        std::vector<std::uint64_t> activeStamp;
+        std::vector<std::uint64_t> matchedStamp;
+        std::vector<std::uint64_t> cliqueStamp;  // cliqueOf[v] is valid while this is current
+        std::vector<std::uint64_t> seenStamp;    // neighbor already counted for the current vertex
+        std::vector<int> cliqueOf;
+        std::uint64_t last = 0;
+
+        // A stamp no entry holds yet (64 bits: never wraps)
+        std::uint64_t fresh(int numVertices) {
+            if (static_cast<int>(activeStamp.size()) < numVertices) {
+                activeStamp.resize(numVertices, 0);
+                matchedStamp.resize(numVertices, 0);
+                cliqueStamp.resize(numVertices, 0);
+                seenStamp.resize(numVertices, 0);
+                cliqueOf.resize(numVertices, -1);
+            }
+            return ++last;
+        }
+    };
+
+    Scratch& scratch() {
+        thread_local Scratch s;
+        return s;
+    }
+
+    // Residual vertices in increasing order plus a membership stamp indexed by vertex
+    struct Residual {
+        Scratch& scratch;
+        std::vector<int> vertices;
+        std::uint64_t stamp;
+
+        Residual(const Graph& graph, const State& state)
+            : scratch(::scratch())
+            , vertices(state.possibleVertices.begin(), state.possibleVertices.end())
+            , stamp(scratch.fresh(graph.numVertices)) {
+            std::sort(vertices.begin(), vertices.end());
+            for (int v : vertices) scratch.activeStamp[v] = stamp;
+        }
+
+        bool active(int v) const { return scratch.activeStamp[v] == stamp; }
+    };
+
+    int greedyMatching(const Graph& graph, const Residual& residual) {
+        Scratch& s = residual.scratch;
+        const std::uint64_t matched = s.fresh(graph.numVertices);
+        int size = 0;
+        for (int v : residual.vertices) {
+            if (s.matchedStamp[v] == matched) continue;
+            for (int u : graph.adjacencyList[v]) {
+                if (residual.active(u) && s.matchedStamp[u] != matched && u != v) {
+                    s.matchedStamp[u] = s.matchedStamp[v] = matched;
+                    ++size;
+                    break;
+                }
+            }
+        }
+        return size;
+    }
+
+    int cliqueCover(const Graph& graph, const Residual& residual) {
+        Scratch& s = residual.scratch;
+        const std::uint64_t assigned = s.fresh(graph.numVertices);
+        std::vector<int> cliqueSize;
+        std::vector<int> hits;      // per clique: members adjacent to the current vertex
+        std::vector<int> touched;
+        for (int v : residual.vertices) {
+            touched.clear();
+            // Each neighbor counts once, so duplicate edges cannot make v look adjacent to
+            // a whole clique it is not (that would overestimate the bound)
+            const std::uint64_t seen = s.fresh(graph.numVertices);
+            for (int u : graph.adjacencyList[v]) {
+                if (s.cliqueStamp[u] != assigned || !residual.active(u) || s.seenStamp[u] == seen) continue;
+                s.seenStamp[u] = seen;
+                const int c = s.cliqueOf[u];
+                if (hits[c]++ == 0) touched.push_back(c);
+            }
+            int best = -1;
+            for (int c : touched) {
+                if (hits[c] == cliqueSize[c] && (best < 0 || cliqueSize[c] > cliqueSize[best])) best = c;
+                hits[c] = 0;
+            }
+            if (best < 0) {
+                best = static_cast<int>(cliqueSize.size());
+                cliqueSize.push_back(0);
+                hits.push_back(0);
+            }
+            s.cliqueStamp[v] = assigned;
+            s.cliqueOf[v] = best;
+            ++cliqueSize[best];
+        }
+        return static_cast<int>(residual.vertices.size() - cliqueSize.size());
+    }
+}
+
+namespace bounds {
+
+    int greedyMatching(const Graph& graph, const State& state) {
+        return ::greedyMatching(graph, Residual(graph, state));
+    }
+
+    int cliqueCover(const Graph& graph, const State& state) {
+        return ::cliqueCover(graph, Residual(graph, state));
+    }
+
+    int residualLowerBound(const Graph& graph, const State& state) {
+        if (state.possibleVertices.empty()) return 0;
+        const Residual residual(graph, state);
+        const int lp = state.lpBound >= 0.0 ? static_cast<int>(std::ceil(state.lpBound - 1e-9))
+                                            : ::greedyMatching(graph, residual);
+        return std::max(lp, ::cliqueCover(graph, residual));
+    }
+}
@@ -0,0 +1,41 @@
+#ifndef BOUNDS_HPP
+#define BOUNDS_HPP
+
+#include "utils.hpp"
+
+/**
+ * @brief Cheap lower bounds on the minimum vertex cover of a state's residual graph
+ *        (the subgraph induced by possibleVertices).
+ *
+ * Each bound sorts the residual and scans the full-graph adjacency of its vertices, so it
+ * costs O(r log r + sum of their degrees) for r residual vertices; vertex-indexed scratch is
+ * kept per thread and reused. The residual is visited in vertex order, so the bounds do not
+ * depend on the hash order of possibleVertices.
+ */
+namespace bounds {
+
+    /**
+     * @brief Size of a greedy maximal matching; every cover holds one endpoint of each matched edge.
+     */
+    int greedyMatching(const Graph& graph, const State& state);
+
+    /**
+     * @brief Clique-cover bound: the residual is greedily split into disjoint cliques, and a
+     *        cover holds all but one vertex of each, so |residual| - #cliques is a lower bound.
+     *
+     * A vertex joins the largest existing clique it is fully adjacent to, else opens a new one.
+     * Adjacency is read as a set: duplicate edges in the graph count once.
+     */
+    int cliqueCover(const Graph& graph, const State& state);
+
+    /**
+     * @brief Best of the bounds above for the residual.
+     *
+     * Uses the exact LP optimum ceil(state.lpBound) when Rule 4 recorded it (a maximum
+     * matching never exceeds it, so the greedy matching is skipped), the greedy matching
+     * otherwise, and the clique cover, which beats the LP on dense residuals.
+     */
+    int residualLowerBound(const Graph& graph, const State& state);
+}
+
+#endif // BOUNDS_HPP
@@ -0,0 +1,308 @@
+#include "crown.hpp"
+#include "parallel.hpp"
+#include "stats.hpp"
+#include <algorithm>
+#include <limits>
+#include <mutex>
+#include <queue>
+
+namespace {
+    constexpr int kInf = std::numeric_limits<int>::max();
+    constexpr int kFrontierGrain = 64;
+}
+
+NemhauserTrotter::NemhauserTrotter(int n, const std::vector<std::vector<int>>& adj,
+                                   const std::unordered_set<int>& possible, WorkStealingPool* pool)
+    : n(n), adj(adj), pool(pool), active(n, 0), pairU(n, -1), pairV(n, -1), dist(n) {
+    vertices.reserve(possible.size());
+    for (int u : possible) {
+        active[u] = 1;
+        vertices.push_back(u);
+    }
+    std::sort(vertices.begin(), vertices.end());
+}
+
+bool NemhauserTrotter::bfs() {
+    std::queue<int> q;
+    int distNIL = kInf;
+
+    for (int u : vertices) {
+        if (pairU[u] == -1) {
+            dist[u] = 0;
+            q.push(u);
+        } else {
+            dist[u] = kInf;
+        }
+    }
+
+    while (!q.empty()) {
+        int u = q.front();
+        q.pop();
+
+        if (dist[u] < distNIL) {
+            for (int v : adj[u]) {
+                if (!active[v]) continue;
+                // Edge u_L -> v_R
+                if (pairV[v] == -1) {
+                    if (distNIL == kInf) {
+                        distNIL = dist[u] + 1;
+                    }
+                } else if (dist[pairV[v]] == kInf) {
+                    dist[pairV[v]] = dist[u] + 1;
+                    q.push(pairV[v]);
+                }
+            }
+        }
+    }
+    return distNIL != kInf;
+}
+
+bool NemhauserTrotter::dfs(int u) {
+    if (u != -1) {
+        for (int v : adj[u]) {
+            if (!active[v]) continue;
+            if (pairV[v] == -1 || (dist[pairV[v]] == dist[u] + 1 && dfs(pairV[v]))) {
+                pairV[v] = u;
+                pairU[u] = v;
+                return true;
+            }
+        }
+        dist[u] = kInf;
+        return false;
+    }
+    return true;
+}
+
+bool NemhauserTrotter::parallelDfs(int u, std::vector<std::atomic<char>>& claimed) {
+    for (int v : adj[u]) {
+        if (!active[v]) continue;
+        // Claiming v first makes concurrent augmenting paths vertex-disjoint:
+        // only the claimer reads or rewrites pairV[v] (and thus owns its partner).
+        if (claimed[v].exchange(1)) continue;
+        int w = pairV[v];
+        if (w == -1 || (level[w].load(std::memory_order_relaxed) == level[u].load(std::memory_order_relaxed) + 1
+                        && parallelDfs(w, claimed))) {
+            pairV[v] = u;
+            pairU[u] = v;
+            return true;
+        }
+    }
+    return false;
+}
+
+int NemhauserTrotter::parallelPhase() {
+    // Level-synchronous BFS from all free left vertices
+    std::vector<int> frontier;
+    std::vector<int> freeLeft;
+    for (int u : vertices) {
+        if (pairU[u] == -1) {
+            level[u].store(0, std::memory_order_relaxed);
+            frontier.push_back(u);
+            freeLeft.push_back(u);
+        } else {
+            level[u].store(kInf, std::memory_order_relaxed);
+        }
+    }
+
+    std::atomic<bool> foundFree(false);
+    std::mutex mergeMutex;
+    for (int depth = 0; !frontier.empty() && !foundFree; ++depth) {
+        std::vector<int> next;
+        pool->parallelFor(0, static_cast<int>(frontier.size()), kFrontierGrain, [&](int lo, int hi) {
+            std::vector<int> local;
+            bool localFound = false;
+            for (int i = lo; i < hi; ++i) {
+                int u = frontier[i];
+                for (int v : adj[u]) {
+                    if (!active[v]) continue;
+                    int w = pairV[v];
+                    if (w == -1) {
+                        localFound = true;
+                    } else {
+                        int expected = kInf;
+                        if (level[w].compare_exchange_strong(expected, depth + 1, std::memory_order_relaxed)) {
+                            local.push_back(w);
+                        }
+                    }
+                }
+            }
+            if (localFound) foundFree = true;
+            if (!local.empty()) {
+                std::lock_guard<std::mutex> lock(mergeMutex);
+                next.insert(next.end(), local.begin(), local.end());
+            }
+        });
+        frontier.swap(next);
+    }
+    if (!foundFree) return 0;
+
+    // Concurrent vertex-disjoint augmenting DFS from every free left vertex
+    std::vector<std::atomic<char>> claimed(n);
+    std::atomic<int> augmented(0);
+    pool->parallelFor(0, static_cast<int>(freeLeft.size()), 1, [&](int lo, int hi) {
+        for (int i = lo; i < hi; ++i) {
+            if (parallelDfs(freeLeft[i], claimed)) augmented++;
+        }
+    });
+    return augmented;
+}
+
+void NemhauserTrotter::computeMaxMatching() {
+    MCTS_STATS_SCOPE(Matching);
+    matched = true;
+    const bool parallel = pool && pool->size() > 1 && static_cast<int>(vertices.size()) >= kParallelThreshold;
+    if (parallel) {
+        level = std::vector<std::atomic<int>>(n);
+        while (true) {
+            if (parallelPhase() > 0) continue;
+            // Either maximum, or concurrent claims blocked every path this phase:
+            // a sequential phase settles which.
+            if (!bfs()) break;
+            for (int u : vertices) {
+                if (pairU[u] == -1) dfs(u);
+            }
+        }
+        return;
+    }
+
+    while (bfs()) {
+        for (int u : vertices) {
+            if (pairU[u] == -1) {
+                dfs(u);
+            }
+        }
+    }
+}
+
+void NemhauserTrotter::koenigReachable(std::vector<bool>& Z_L, std::vector<bool>& Z_R) const {
+    // Koenig's construction for Min Vertex Cover in Bipartite Graph
+    // Z = Set of vertices reachable from Unmatched_L via alternating paths
+    // MVC = (L \ Z) U (R \cap Z)
+    Z_L.assign(n, false);
+    Z_R.assign(n, false);
+    std::queue<int> q;
+
+    // Start with unmatched vertices in Left
+    for (int u : vertices) {
+        if (pairU[u] == -1) {
+            Z_L[u] = true;
+            q.push(u);
+        }
+    }
+
+    while (!q.empty()) {
+        int u = q.front();
+        q.pop();
+
+        // u is in L. Traverse edges L->R (non-matching)
+        // In our bipartite check, all edges (u, v) exist.
+        // The edge used in matching is (u, pairU[u]). All others are non-matching.
+        for (int v : adj[u]) {
+            if (!active[v]) continue;
+
+            // We can only follow non-matching edges from L to R
+            // If pairU[u] == v, this is a matching edge.
+            if (pairU[u] == v) continue;
+
+            if (!Z_R[v]) {
+                Z_R[v] = true;
+                // From v in R, follow matching edge to L (if exists)
+                if (pairV[v] != -1) {
+                    int w = pairV[v]; // w is in L
+                    if (!Z_L[w]) {
+                        Z_L[w] = true;
+                        q.push(w);
+                    }
+                }
+            }
+        }
+    }
+}
+
+void NemhauserTrotter::getKernelNodes(std::vector<int>& toInclude, std::vector<int>& toExclude) {
+    computeMaxMatching();
+
+    // 1. Find Z_L and Z_R
+    std::vector<bool> Z_L, Z_R;
+    koenigReachable(Z_L, Z_R);
+
+    // 2. Identify P0 and P1 based on NT Theorem
+    // C_L = { u | !Z_L[u] }
+    // C_R = { v | Z_R[v] }
+    // Include u if matches on both sides: u_L \in C_L AND u_R \in C_R
+    // => !Z_L[u] AND Z_R[u]
+    // Exclude u if matches on neither side: u_L \notin C_L AND u_R \notin C_K
+    // => Z_L[u] AND !Z_R[u]
+
+    for (int u : vertices) {
+        bool inC_L = !Z_L[u];
+        bool inC_R = Z_R[u];
+
+        if (inC_L && inC_R) {
+            toInclude.push_back(u);
+        } else if (!inC_L && !inC_R) {
+            toExclude.push_back(u);
+        }
+    }
+}
+
+void NemhauserTrotter::setMaxMatching(const std::vector<std::pair<int, int>>& pairs) {
+    for (const auto& pair : pairs) {
+        pairU[pair.first] = pair.second;
+        pairV[pair.second] = pair.first;
+    }
+    matched = true;
+}
+
+std::vector<std::pair<int, int>> NemhauserTrotter::matchedPairs() const {
+    std::vector<std::pair<int, int>> pairs;
+    for (int u : vertices) {
+        if (pairU[u] != -1) pairs.emplace_back(u, pairU[u]);
+    }
+    return pairs;
+}
+
+int NemhauserTrotter::matchingSize() const {
+    int size = 0;
+    for (int u : vertices) {
+        if (pairU[u] != -1) ++size;
+    }
+    return size;
+}
+
+void NemhauserTrotter::getLPSolution(std::vector<double>& x) {
+    if (!matched) computeMaxMatching();
+    std::vector<bool> Z_L, Z_R;
+    koenigReachable(Z_L, Z_R);
+    x.assign(n, 0.0);
+    for (int u : vertices) {
+        // u_L in the cover iff !Z_L[u]; u_R in the cover iff Z_R[u]
+        x[u] = 0.5 * ((Z_L[u] ? 0 : 1) + (Z_R[u] ? 1 : 0));
+    }
+}
+
+double NemhauserTrotter::lpBoundWithout(const std::vector<int>& removed) {
+    if (!matched) computeMaxMatching();
+    const std::vector<int> savedU = pairU;
+    const std::vector<int> savedV = pairV;
+    const std::vector<int> savedVertices = vertices;
+
+    std::vector<int> deactivated;
+    for (int u : removed) {
+        if (!active[u]) continue;
+        active[u] = 0;
+        deactivated.push_back(u);
+        if (pairU[u] != -1) { pairV[pairU[u]] = -1; pairU[u] = -1; }
+        if (pairV[u] != -1) { pairU[pairV[u]] = -1; pairV[u] = -1; }
+    }
+    vertices.erase(std::remove_if(vertices.begin(), vertices.end(), [&](int u) { return !active[u]; }),
+                   vertices.end());
+    computeMaxMatching();
+    const double bound = lpBound();
+
+    for (int u : deactivated) active[u] = 1;
+    vertices = savedVertices;
+    pairU = savedU;
+    pairV = savedV;
+    return bound;
+}
@@ -0,0 +1,128 @@
+#ifndef CROWN_HPP
+#define CROWN_HPP
+
+#include <atomic>
+#include <vector>
+#include <unordered_set>
+#include <utility>
+
+class WorkStealingPool;
+
+/**
+ * @brief Hopcroft-Karp on the bipartite doubling of the graph, used for
+ *        Nemhauser-Trotter (Crown) kernelization.
+ *
+ * We model a bipartite graph with Left (0..n-1) and Right (0..n-1).
+ * Edge u-v in G implies edges (u_L, v_R) and (v_L, u_R) in bipartite graph.
+ * Only vertices in `possible` take part.
+ *
+ * The same matching solves the MVC LP relaxation exactly: a maximum matching M of
+ * the doubling gives LP optimum |M| / 2, and the König cover C gives the
+ * half-integral optimum x_u = ([u_L in C] + [u_R in C]) / 2.
+ */
+class NemhauserTrotter {
+public:
+
+    /**
+     * @brief Residual size (vertices) from which the parallel matching is used.
+     */
+    static constexpr int kParallelThreshold = 256;
+
+    /**
+     * @param n Number of vertices of the full graph.
+     * @param adj Adjacency lists of the full graph.
+     * @param possible Vertices of the residual graph.
+     * @param pool Optional pool for the parallel matching; nullptr keeps the sequential path.
+     */
+    NemhauserTrotter(int n, const std::vector<std::vector<int>>& adj, const std::unordered_set<int>& possible,
+                     WorkStealingPool* pool = nullptr);
+
+    /**
+     * @brief Computes a maximum matching of the bipartite doubling.
+     *
+     * Uses the parallel phases when a pool with more than one worker is attached
+     * and the residual has at least kParallelThreshold vertices.
+     */
+    void computeMaxMatching();
+
+    /**
+     * @brief Computes the NT kernel: vertices forced into / out of some minimum cover.
+     * @param toInclude Receives vertices u with u_L and u_R both in the König cover.
+     * @param toExclude Receives vertices u with neither u_L nor u_R in the König cover.
+     */
+    void getKernelNodes(std::vector<int>& toInclude, std::vector<int>& toExclude);
+
+    /**
+     * @brief Starts from a known maximum matching of this residual instead of computing one.
+     * @param pairs Matched (u_L, v_R) pairs of an earlier run on the same residual, e.g.
+     *        State::lpMatching; both endpoints must be residual vertices.
+     */
+    void setMaxMatching(const std::vector<std::pair<int, int>>& pairs);
+
+    /**
+     * @brief Matched (u_L, v_R) pairs of the current matching, by increasing u.
+     */
+    std::vector<std::pair<int, int>> matchedPairs() const;
+
+    /**
+     * @brief Size of the current matching (maximum after computeMaxMatching()).
+     */
+    int matchingSize() const;
+
+    /**
+     * @brief LP relaxation optimum of the residual graph, |M| / 2 (after computeMaxMatching()).
+     */
+    double lpBound() const { return matchingSize() / 2.0; }
+
+    /**
+     * @brief Exact half-integral LP solution from the König cover (computes the matching if needed).
+     * @param x Resized to n; x[u] in {0, 0.5, 1} for residual vertices, 0 elsewhere.
+     */
+    void getLPSolution(std::vector<double>& x);
+
+    /**
+     * @brief LP optimum of the residual with some vertices deleted.
+     *
+     * Warm-starts from the current maximum matching: deleting k vertices breaks at
+     * most 2k matched edges, so only a few augmentations are needed. The matching
+     * and residual are restored afterwards.
+     * @param removed Residual vertices to delete.
+     */
+    double lpBoundWithout(const std::vector<int>& removed);
+
+private:
+    bool bfs();
+    bool dfs(int u);
+
+    /**
+     * @brief One Hopcroft-Karp phase with level-synchronous parallel BFS and
+     *        concurrent vertex-disjoint augmenting DFS.
+     * @return Number of augmenting paths applied (0 once the matching is maximum
+     *         or when the concurrent DFS found nothing; callers then fall back to a
+     *         sequential phase).
+     */
+    int parallelPhase();
+    bool parallelDfs(int u, std::vector<std::atomic<char>>& claimed);
+
+    /**
+     * @brief König's construction: marks the left/right copies reachable from free
+     *        left vertices by alternating paths (cover = (L \ Z_L) u (R n Z_R)).
+     */
+    void koenigReachable(std::vector<bool>& Z_L, std::vector<bool>& Z_R) const;
+
+    int n;
+    const std::vector<std::vector<int>>& adj;
+    WorkStealingPool* pool;
+
+    std::vector<int> vertices;  // residual vertices in increasing order
+    std::vector<char> active;   // active[v] <=> v is in the residual
+
+    // Bipartite matching structures
+    std::vector<int> pairU; // Left u -> Right v
+    std::vector<int> pairV; // Right v -> Left u
+    std::vector<int> dist;  // For BFS
+    std::vector<std::atomic<int>> level; // BFS layers of the parallel phase
+    bool matched = false;   // computeMaxMatching() has run
+};
+
+#endif // CROWN_HPP
@@ -0,0 +1,986 @@
+#include "estimator.hpp"
+#include "crown.hpp"
+#include "parallel.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <sstream>
+
+namespace {
+    // Trials solved together in one pass over the edge list: one SIMD lane each
+    // (AVX-512: 8 doubles, AVX/AVX2: 4, SSE2 baseline: 2).
+#if defined(__AVX512F__)
+    constexpr int kLanes = 8;
+#elif defined(__AVX__)
+    constexpr int kLanes = 4;
+#else
+    constexpr int kLanes = 2;
+#endif
+
+    // One vector register of kLanes doubles (GCC/Clang vector extension).
+    typedef double LaneVec __attribute__((vector_size(kLanes * sizeof(double))));
+    const LaneVec kZeros = {};
+    const LaneVec kOnes = kZeros + 1.0;
+
+    inline LaneVec loadLanes(const double* p) {
+        LaneVec v;
+        std::memcpy(&v, p, sizeof(v));
+        return v;
+    }
+
+    inline void storeLanes(double* p, LaneVec v) {
+        std::memcpy(p, &v, sizeof(v));
+    }
+
+    // Capacity of the per-thread scratch below, summed over live threads (memory reports)
+    std::atomic<std::size_t> g_scratchBytes{0};
+
+    // Per-thread scratch so repeated estimator calls do not allocate.
+    struct LaneScratch {
+        std::vector<double> x, c, grad;
+        std::size_t counted = 0;
+
+        // Publishes capacity growth to g_scratchBytes
+        void account() {
+            const std::size_t bytes = (x.capacity() + c.capacity() + grad.capacity()) * sizeof(double);
+            if (bytes != counted) {
+                g_scratchBytes.fetch_add(bytes - counted, std::memory_order_relaxed);
+                counted = bytes;
+            }
+        }
+
+        ~LaneScratch() { g_scratchBytes.fetch_sub(counted, std::memory_order_relaxed); }
+    };
+    thread_local LaneScratch tl_scratch;
+
+    // Projected gradient on min sum_i c_i x_i + mu * sum_(u,w) [max(0, 1 - x_u - x_w)]^2, 0<=x_i<=1
+    // for kLanes perturbed trials at once. Arrays are vertex-major with interleaved trials (kLanes per vertex),
+    // so each edge costs two vector loads/stores per endpoint instead of kLanes scalar passes.
+    // Starts from warm (the same layout, strideT trials per global vertex) when given, else x = 0.5.
+    // The iterate keeps oscillating at this step size, so convergence is judged on the penalty
+    // objective: stop once its best value has not improved by plateauTolerance (relative) for
+    // `patience` iterations. Returns iterations run.
+    int solveLaneBlock(const std::vector<int>& activeVerts, const std::vector<int>& edgeA,
+                       const std::vector<int>& edgeB, int firstTrial,
+                       const estimator::PerturbationLPConfig& config, int* hits,
+                       const std::vector<double>* warm, std::vector<double>* finalX, int strideT) {
+        const int n = static_cast<int>(activeVerts.size());
+        const int m = static_cast<int>(edgeA.size());
+        const std::size_t size = static_cast<std::size_t>(n) * kLanes;
+        LaneScratch& scratch = tl_scratch;
+        scratch.x.assign(size, 0.5);
+        if (warm) {
+            for (int i = 0; i < n; ++i) {
+                const double* src = warm->data() + static_cast<std::size_t>(activeVerts[i]) * strideT + firstTrial;
+                std::memcpy(scratch.x.data() + static_cast<std::size_t>(i) * kLanes, src, kLanes * sizeof(double));
+            }
+        }
+        scratch.c.resize(size);
+        scratch.grad.resize(size);
+        scratch.account();
+        double* x = scratch.x.data();
+        double* c = scratch.c.data();
+        double* grad = scratch.grad.data();
+
+        for (int i = 0; i < n; ++i) {
+            int vg = activeVerts[i];
+            for (int t = 0; t < kLanes; ++t) {
+                double phase = static_cast<double>((vg + 1) * 131 + (firstTrial + t + 1) * 977);
+                c[i * kLanes + t] = 1.0 + config.delta * std::sin(phase);
+            }
+        }
+
+        const double lr = config.lr;
+        const double twoMu = 2.0 * config.mu;
+        const bool plateauStop = config.patience > 0;
+        double bestObjective = std::numeric_limits<double>::infinity();
+        int lastImprovement = 0;
+        int it = 0;
+        while (it < config.iterations) {
+            ++it;
+            std::memcpy(grad, c, size * sizeof(double));
+            LaneVec penalty = kZeros;
+            for (int e = 0; e < m; ++e) {
+                double* ga = grad + edgeA[e] * kLanes;
+                double* gb = grad + edgeB[e] * kLanes;
+                LaneVec viol = kOnes - loadLanes(x + edgeA[e] * kLanes) - loadLanes(x + edgeB[e] * kLanes);
+                // Branchless: adds -0.0 on satisfied edges, same result as skipping them
+                LaneVec pos = viol > kZeros ? viol : kZeros;
+                LaneVec g = -twoMu * pos;
+                storeLanes(ga, loadLanes(ga) + g);
+                storeLanes(gb, loadLanes(gb) + g);
+                if (plateauStop) penalty += pos * pos;
+            }
+            double linear = 0.0;
+            for (std::size_t k = 0; k < size; ++k) {
+                if (plateauStop) linear += c[k] * x[k];
+                double v = x[k] - lr * grad[k];
+                v = v < 0.0 ? 0.0 : v;
+                x[k] = v > 1.0 ? 1.0 : v;
+            }
+            if (plateauStop) {
+                double objective = linear;
+                for (int t = 0; t < kLanes; ++t) objective += config.mu * penalty[t];
+                if (objective < bestObjective * (1.0 - config.plateauTolerance)) {
+                    bestObjective = objective;
+                    lastImprovement = it;
+                } else if (it - lastImprovement >= config.patience) {
+                    break;
+                }
+            }
+        }
+
+        // Unrepaired iterate is what the next (child) solve starts from
+        if (finalX) {
+            for (int i = 0; i < n; ++i) {
+                double* dst = finalX->data() + static_cast<std::size_t>(activeVerts[i]) * strideT + firstTrial;
+                std::memcpy(dst, x + static_cast<std::size_t>(i) * kLanes, kLanes * sizeof(double));
+            }
+        }
+
+        // quick feasibility repair for tiny residual violations
+        for (int e = 0; e < m; ++e) {
+            double* xa = x + edgeA[e] * kLanes;
+            double* xb = x + edgeB[e] * kLanes;
+            for (int t = 0; t < kLanes; ++t) {
+                double deficit = 1.0 - xa[t] - xb[t];
+                double add = 0.5 * (deficit > 0.0 ? deficit : 0.0);
+                xa[t] = std::min(1.0, xa[t] + add);
+                xb[t] = std::min(1.0, xb[t] + add);
+            }
+        }
+
+        // Padding lanes beyond config.trials are solved but not counted
+        const int lanesUsed = std::min(kLanes, config.trials - firstTrial);
+        for (int i = 0; i < n; ++i) {
+            int h = 0;
+            for (int t = 0; t < lanesUsed; ++t) {
+                if (x[i * kLanes + t] > 0.5) ++h;
+            }
+            hits[i] = h;
+        }
+        return it;
+    }
+
+    // Uniform index in [0, bound) / uniform double in [0, 1) from a local engine
+    inline std::size_t drawIndex(Xoshiro256& engine, std::size_t bound) {
+        return static_cast<std::size_t>((static_cast<unsigned __int128>(engine()) * bound) >> 64);
+    }
+
+    inline double draw01(Xoshiro256& engine) {
+        return static_cast<double>(engine() >> 11) * 0x1.0p-53;
+    }
+
+    // Samples per chain of the fixed Gibbs budget
+    int samplesPerChain(const estimator::GibbsConfig& config) {
+        const int chains = std::max(1, config.chains);
+        return std::max(1, (config.samplingSteps / config.sampleStride + chains - 1) / chains);
+    }
+
+    // Gibbs chains over the residual of `state`. Counts, per residual vertex (or only for
+    // countOnly when >= 0), the samples in which it is selected, summed over all chains.
+    // Returns false if the residual has no edges.
+    bool runGibbsChain(const State& state, const Graph& graph, const estimator::GibbsConfig& config,
+                       std::uint64_t seed, int countOnly, std::vector<int>& activeVerts,
+                       std::vector<int>& hits, int& sampled, estimator::SolveTrace* trace) {
+        // Active core indexing
+        activeVerts.clear();
+        activeVerts.reserve(state.possibleVertices.size());
+        std::vector<int> idxOf(graph.numVertices, -1);
+        for (int u : state.possibleVertices) {
+            idxOf[u] = static_cast<int>(activeVerts.size());
+            activeVerts.push_back(u);
+        }
+        const int n = static_cast<int>(activeVerts.size());
+
+        // Local adjacency on the active core (CSR)
+        std::vector<int> start(n + 1, 0), nbrs;
+        for (int u = 0; u < n; ++u) {
+            for (int vg : graph.adjacencyList[activeVerts[u]]) {
+                if (idxOf[vg] >= 0) nbrs.push_back(idxOf[vg]);
+            }
+            start[u + 1] = static_cast<int>(nbrs.size());
+        }
+        if (nbrs.empty()) return false;
+
+        // Start from the warm sampler state (repaired to a cover), else from all selected
+        const std::vector<double>* warm = trace ? trace->warmStart : nullptr;
+        if (warm && warm->size() != static_cast<std::size_t>(graph.numVertices)) warm = nullptr;
+        std::vector<char> initial(n, 1);
+        if (warm) {
+            for (int i = 0; i < n; ++i) initial[i] = (*warm)[activeVerts[i]] > 0.5;
+            for (int u = 0; u < n; ++u) {
+                for (int e = start[u]; e < start[u + 1]; ++e) {
+                    if (!initial[u] && !initial[nbrs[e]]) initial[u] = 1;
+                }
+            }
+        }
+
+        // Chain c owns selected[c * n + i] and freeNbrs[c * n + i] (unselected neighbors of i):
+        // i can leave the cover iff freeNbrs is 0, and a flip updates its neighbors in O(deg).
+        const int chains = std::max(1, config.chains);
+        std::vector<char> selected(static_cast<std::size_t>(chains) * n);
+        std::vector<int> freeNbrs(static_cast<std::size_t>(chains) * n, 0);
+        for (int c = 0; c < chains; ++c) {
+            std::copy(initial.begin(), initial.end(), selected.begin() + static_cast<std::ptrdiff_t>(c) * n);
+            for (int u = 0; u < n; ++u) {
+                for (int e = start[u]; e < start[u + 1]; ++e) freeNbrs[c * n + u] += !initial[nbrs[e]];
+            }
+        }
+        std::vector<Xoshiro256> engines;
+        engines.reserve(chains);
+        for (int c = 0; c < chains; ++c) engines.emplace_back(seed, c);
+
+        const double addAcceptProb = std::exp(-config.beta); // 0->1 acceptance
+        const int maxBurnIn = warm ? config.warmBurnIn : config.burnIn;
+        const int perChain = samplesPerChain(config);
+        const int onlyIdx = countOnly >= 0 ? idxOf[countOnly] : -1;
+
+        // Per-chain burn-in: ends at maxBurnIn, or (adaptive) once the acceptance rate of one
+        // window is within acceptanceTolerance of the previous window's
+        std::vector<int> burnIn(chains, -1), collected(chains, 0), accepted(chains, 0);
+        std::vector<double> lastRate(chains, -1.0);
+        const int window = std::max(1, config.burnInWindow);
+
+        const estimator::SequentialStopping& rule = config.stopping;
+        hits.assign(n, 0);
+        sampled = 0;
+        int active = chains;
+        for (int step = 0; active > 0; ++step) {
+            const int sampledBefore = sampled;
+            for (int c = 0; c < chains; ++c) {
+                if (collected[c] >= perChain) continue;
+                char* sel = &selected[static_cast<std::size_t>(c) * n];
+                int* freeCount = &freeNbrs[static_cast<std::size_t>(c) * n];
+                const int i = static_cast<int>(drawIndex(engines[c], n));
+                int flip = 0;
+                if (sel[i]) {
+                    if (freeCount[i] == 0) flip = -1; // always accept energy-decreasing feasible removal
+                } else if (draw01(engines[c]) < addAcceptProb) {
+                    flip = 1;
+                }
+                if (flip) {
+                    sel[i] = flip > 0;
+                    for (int e = start[i]; e < start[i + 1]; ++e) freeCount[nbrs[e]] -= flip;
+                    ++accepted[c];
+                }
+
+                if (burnIn[c] < 0) {
+                    const int done = step + 1;
+                    if (done >= maxBurnIn) {
+                        burnIn[c] = done;
+                    } else if (config.adaptiveBurnIn && done % window == 0) {
+                        const double rate = static_cast<double>(accepted[c]) / window;
+                        if (lastRate[c] >= 0.0 && std::fabs(rate - lastRate[c]) <= config.acceptanceTolerance) {
+                            burnIn[c] = done;
+                        }
+                        lastRate[c] = rate;
+                        accepted[c] = 0;
+                    }
+                } else if ((step - burnIn[c]) % config.sampleStride == 0) {
+                    ++sampled;
+                    if (onlyIdx >= 0) {
+                        hits[onlyIdx] += sel[onlyIdx];
+                    } else {
+                        for (int k = 0; k < n; ++k) hits[k] += sel[k];
+                    }
+                    if (++collected[c] == perChain) --active;
+                }
+            }
+
+            // Sequential stopping (samples are autocorrelated, so the interval is optimistic)
+            if (rule.enabled && active > 0 && sampled > sampledBefore && sampled >= config.minSamples) {
+                const double scale = 1.0 / std::max(1.0, config.sampleCorrelation);
+                auto decidedAt = [&](int k) {
+                    return estimator::wilsonDecided(static_cast<int>(hits[k] * scale + 0.5),
+                                                    static_cast<int>(sampled * scale), rule);
+                };
+                bool decided;
+                if (onlyIdx >= 0) {
+                    decided = decidedAt(onlyIdx);
+                } else {
+                    int count = 0;
+                    for (int k = 0; k < n; ++k) count += decidedAt(k);
+                    decided = count >= rule.batchQuorum * n;
+                }
+                if (decided) break;
+            }
+        }
+
+        if (trace) {
+            trace->warm = warm != nullptr;
+            trace->iterations = *std::max_element(burnIn.begin(), burnIn.end());
+            trace->samples = sampled;
+            if (trace->finalX) {
+                trace->finalX->assign(graph.numVertices, 0.0);
+                for (int k = 0; k < n; ++k) (*trace->finalX)[activeVerts[k]] = selected[k];
+            }
+        }
+        return true;
+    }
+
+    // Residual adjacency in local indices (activeVerts sorted), degrees and core numbers
+    struct ResidualCsr {
+        std::vector<int> start, nbrs, deg, core;
+        int maxDeg = 0;
+        int maxCore = 0;
+    };
+
+    void residualCsr(const Graph& graph, const std::vector<int>& activeVerts, ResidualCsr& csr) {
+        const int n = static_cast<int>(activeVerts.size());
+        std::vector<int> idxOf(graph.numVertices, -1);
+        for (int i = 0; i < n; ++i) idxOf[activeVerts[i]] = i;
+
+        std::vector<int>& start = csr.start;
+        std::vector<int>& nbrs = csr.nbrs;
+        std::vector<int>& deg = csr.deg;
+        start.assign(n + 1, 0);
+        nbrs.clear();
+        for (int i = 0; i < n; ++i) {
+            for (int w : graph.adjacencyList[activeVerts[i]]) {
+                if (idxOf[w] >= 0) nbrs.push_back(idxOf[w]);
+            }
+            start[i + 1] = static_cast<int>(nbrs.size());
+        }
+        deg.assign(n, 0);
+        int maxDeg = 0;
+        for (int i = 0; i < n; ++i) {
+            deg[i] = start[i + 1] - start[i];
+            maxDeg = std::max(maxDeg, deg[i]);
+        }
+
+        // Core numbers by bucket peeling
+        std::vector<int>& core = csr.core;
+        core = deg;
+        std::vector<int> order(n), pos(n), bucketStart(maxDeg + 2, 0);
+        for (int i = 0; i < n; ++i) ++bucketStart[deg[i] + 1];
+        for (int d = 0; d <= maxDeg; ++d) bucketStart[d + 1] += bucketStart[d];
+        {
+            std::vector<int> fill(bucketStart.begin(), bucketStart.end() - 1);
+            for (int i = 0; i < n; ++i) {
+                pos[i] = fill[deg[i]]++;
+                order[pos[i]] = i;
+            }
+        }
+        for (int k = 0; k < n; ++k) {
+            const int u = order[k];
+            for (int e = start[u]; e < start[u + 1]; ++e) {
+                const int w = nbrs[e];
+                if (core[w] > core[u]) {
+                    // Move w to the front of its bucket, then shrink it by one
+                    const int first = order[bucketStart[core[w]]];
+                    std::swap(order[pos[w]], order[bucketStart[core[w]]]);
+                    std::swap(pos[w], pos[first]);
+                    ++bucketStart[core[w]];
+                    --core[w];
+                }
+            }
+        }
+        csr.maxDeg = maxDeg;
+        csr.maxCore = n > 0 ? *std::max_element(core.begin(), core.end()) : 0;
+    }
+
+    // Per residual vertex: mean inverse degree of its neighbors and the fraction of its
+    // neighbor pairs that are adjacent. Triangles are listed once each along edges oriented
+    // from lower to higher (degree, index), O(m sqrt(m))
+    void neighborhoodFeatures(const ResidualCsr& csr, std::vector<double>& inverseDegree,
+                              std::vector<double>& redundancy) {
+        const std::vector<int>& start = csr.start;
+        const std::vector<int>& nbrs = csr.nbrs;
+        const std::vector<int>& deg = csr.deg;
+        const int n = static_cast<int>(deg.size());
+        auto before = [&deg](int a, int b) { return deg[a] < deg[b] || (deg[a] == deg[b] && a < b); };
+
+        // Forward neighbors (parallel edges dropped)
+        std::vector<int> forwardStart(n + 1, 0), forward, mark(n, -1);
+        forward.reserve(nbrs.size() / 2);
+        for (int i = 0; i < n; ++i) {
+            for (int e = start[i]; e < start[i + 1]; ++e) {
+                const int u = nbrs[e];
+                if (before(i, u) && mark[u] != i) {
+                    mark[u] = i;
+                    forward.push_back(u);
+                }
+            }
+            forwardStart[i + 1] = static_cast<int>(forward.size());
+        }
+
+        std::vector<long long> triangles(n, 0);
+        std::fill(mark.begin(), mark.end(), -1);
+        for (int i = 0; i < n; ++i) {
+            for (int e = forwardStart[i]; e < forwardStart[i + 1]; ++e) mark[forward[e]] = i;
+            for (int e = forwardStart[i]; e < forwardStart[i + 1]; ++e) {
+                const int u = forward[e];
+                // Branch-free: on dense residuals a large fraction of the probes hit
+                long long closed = 0;
+                for (int e2 = forwardStart[u]; e2 < forwardStart[u + 1]; ++e2) {
+                    const int w = forward[e2];
+                    const int hit = mark[w] == i;
+                    closed += hit;
+                    triangles[w] += hit;
+                }
+                triangles[i] += closed;
+                triangles[u] += closed;
+            }
+        }
+
+        inverseDegree.assign(n, 0.0);
+        redundancy.assign(n, 0.0);
+        for (int i = 0; i < n; ++i) {
+            double inverse = 0.0;
+            for (int e = start[i]; e < start[i + 1]; ++e) inverse += 1.0 / deg[nbrs[e]];
+            const double pairs = 0.5 * deg[i] * (deg[i] - 1);
+            inverseDegree[i] = deg[i] > 0 ? inverse / deg[i] : 0.0;
+            redundancy[i] = pairs > 0 ? static_cast<double>(triangles[i]) / pairs : 0.0;
+        }
+    }
+}
+
+namespace estimator {
+
+    void ConvergenceStats::record(int depth, const SolveTrace& trace, int auditedColdIterations,
+                                  double auditedPriorDelta) {
+        std::vector<Row>& rows = byDepth.local();
+        if (depth >= static_cast<int>(rows.size())) rows.resize(depth + 1);
+        Row& row = rows[depth];
+        if (trace.warm) {
+            row.warmSolves++;
+            row.warmIterations += trace.iterations;
+            if (auditedColdIterations >= 0) {
+                row.auditedColdIterations += auditedColdIterations;
+                row.auditedPriorDelta += auditedPriorDelta;
+            }
+        } else {
+            row.coldSolves++;
+            row.coldIterations += trace.iterations;
+        }
+    }
+
+    std::vector<ConvergenceStats::Row> ConvergenceStats::rows() const {
+        std::vector<Row> merged;
+        byDepth.forEach([&merged](const std::vector<Row>& rows) {
+            if (rows.size() > merged.size()) merged.resize(rows.size());
+            for (std::size_t d = 0; d < rows.size(); ++d) {
+                merged[d].coldSolves += rows[d].coldSolves;
+                merged[d].coldIterations += rows[d].coldIterations;
+                merged[d].warmSolves += rows[d].warmSolves;
+                merged[d].warmIterations += rows[d].warmIterations;
+                merged[d].auditedColdIterations += rows[d].auditedColdIterations;
+                merged[d].auditedPriorDelta += rows[d].auditedPriorDelta;
+            }
+        });
+        return merged;
+    }
+
+    bool wilsonDecided(int hits, int trials, const SequentialStopping& rule) {
+        if (trials <= 0) return false;
+        const double n = static_cast<double>(trials);
+        const double p = static_cast<double>(hits) / n;
+        const double z2 = rule.z * rule.z;
+        const double denom = 1.0 + z2 / n;
+        const double center = (p + z2 / (2.0 * n)) / denom;
+        const double half = rule.z * std::sqrt(p * (1.0 - p) / n + z2 / (4.0 * n * n)) / denom;
+        return center - half > 0.5 || center + half < 0.5 || half <= rule.halfWidth;
+    }
+
+    void BudgetStats::record(const char* estimator, int used, int budget) {
+        Shard& shard = byEstimator.local();
+        auto it = std::find_if(shard.begin(), shard.end(),
+                               [estimator](const std::pair<const char*, Row>& entry) { return entry.first == estimator; });
+        if (it == shard.end()) {
+            shard.emplace_back(estimator, Row());
+            it = shard.end() - 1;
+            it->second.estimator = estimator;
+        }
+        Row& row = it->second;
+        ++row.calls;
+        if (used < budget) ++row.earlyCalls;
+        row.used += used;
+        row.budget += budget;
+    }
+
+    std::vector<BudgetStats::Row> BudgetStats::rows() const {
+        std::vector<Row> merged;
+        byEstimator.forEach([&merged](const Shard& shard) {
+            for (const auto& entry : shard) {
+                const Row& row = entry.second;
+                auto it = std::find_if(merged.begin(), merged.end(),
+                                       [&row](const Row& m) { return m.estimator == row.estimator; });
+                if (it == merged.end()) {
+                    merged.push_back(row);
+                    continue;
+                }
+                it->calls += row.calls;
+                it->earlyCalls += row.earlyCalls;
+                it->used += row.used;
+                it->budget += row.budget;
+            }
+        });
+        return merged;
+    }
+
+    void BudgetStats::reset() {
+        byEstimator.forEach([](Shard& shard) { shard.clear(); });
+    }
+
+    void ConvergenceStats::reset() {
+        byDepth.forEach([](std::vector<Row>& rows) { rows.clear(); });
+    }
+
+    bool perturbationLPFrequencies(const State& state, const Graph& graph, const PerturbationLPConfig& config,
+                                   std::vector<int>& activeVerts, std::vector<double>& frequency, SolveTrace* trace,
+                                   int decideFor) {
+        // Build active vertex index mapping for current core
+        activeVerts.clear();
+        activeVerts.reserve(state.possibleVertices.size());
+        std::vector<int> idxOf(graph.numVertices, -1);
+        for (int u : state.possibleVertices) {
+            idxOf[u] = static_cast<int>(activeVerts.size());
+            activeVerts.push_back(u);
+        }
+        const int n = static_cast<int>(activeVerts.size());
+        frequency.assign(n, 0.0);
+
+        // Build edge list in active core (u < w) using local indices, as two index arrays
+        std::vector<int> edgeA, edgeB;
+        for (int uGlobal : activeVerts) {
+            int u = idxOf[uGlobal];
+            for (int wGlobal : graph.adjacencyList[uGlobal]) {
+                int w = (wGlobal >= 0 && wGlobal < graph.numVertices) ? idxOf[wGlobal] : -1;
+                if (w >= 0 && u < w) {
+                    edgeA.push_back(u);
+                    edgeB.push_back(w);
+                }
+            }
+        }
+        if (edgeA.empty() || config.trials <= 0) return false;
+
+        const int blocks = (config.trials + kLanes - 1) / kLanes;
+        const int strideT = blocks * kLanes;
+        const std::vector<double>* warm = trace ? trace->warmStart : nullptr;
+        if (warm && warm->size() != static_cast<std::size_t>(graph.numVertices) * strideT) warm = nullptr;
+        std::vector<double>* finalX = trace ? trace->finalX : nullptr;
+        if (finalX) finalX->assign(static_cast<std::size_t>(graph.numVertices) * strideT, 0.5);
+
+        std::vector<int> hits(static_cast<std::size_t>(blocks) * n, 0);
+        std::vector<int> blockIterations(blocks, 0);
+        auto runBlocks = [&](int lo, int hi) {
+            for (int b = lo; b < hi; ++b) {
+                blockIterations[b] = solveLaneBlock(activeVerts, edgeA, edgeB, b * kLanes, config,
+                                                    hits.data() + static_cast<std::size_t>(b) * n,
+                                                    warm, finalX, strideT);
+            }
+        };
+
+        // Rounds of one lane block per pool worker; without sequential stopping, one round of all
+        const SequentialStopping& rule = config.stopping;
+        const int workers = config.pool ? config.pool->size() : 1;
+        const int roundBlocks = rule.enabled ? std::max(1, workers) : blocks;
+        const int decideIdx = decideFor >= 0 && decideFor < graph.numVertices ? idxOf[decideFor] : -1;
+        std::vector<int> total(n, 0);
+        int done = 0, trialsDone = 0;
+        while (done < blocks) {
+            const int hi = std::min(blocks, done + std::max(roundBlocks, (config.minTrials - trialsDone + kLanes - 1) / kLanes));
+            if (config.pool && hi - done > 1) {
+                config.pool->parallelFor(done, hi, 1, runBlocks);
+            } else {
+                runBlocks(done, hi);
+            }
+            for (int b = done; b < hi; ++b) {
+                for (int i = 0; i < n; ++i) total[i] += hits[static_cast<std::size_t>(b) * n + i];
+            }
+            done = hi;
+            trialsDone = std::min(config.trials, done * kLanes);
+            if (!rule.enabled || done == blocks || trialsDone < config.minTrials) continue;
+            if (decideIdx >= 0) {
+                if (wilsonDecided(total[decideIdx], trialsDone, rule)) break;
+            } else {
+                int decided = 0;
+                for (int i = 0; i < n; ++i) decided += wilsonDecided(total[i], trialsDone, rule);
+                if (decided >= rule.batchQuorum * n) break;
+            }
+        }
+
+        for (int i = 0; i < n; ++i) frequency[i] = static_cast<double>(total[i]) / static_cast<double>(trialsDone);
+        if (trace) {
+            trace->warm = warm != nullptr;
+            trace->iterations = *std::max_element(blockIterations.begin(), blockIterations.begin() + done);
+            trace->samples = trialsDone;
+        }
+        return true;
+    }
+
+    void perturbationLPBatch(const State& state, const Graph& graph, std::vector<double>& prior,
+                             std::vector<double>& warmStart) {
+        const PerturbationLPConfig& config = perturbationLPConfig;
+        std::vector<int> activeVerts;
+        std::vector<double> frequency;
+        SolveTrace trace;
+        trace.warmStart = useWarmStarts ? state.warmStart.get() : nullptr;
+        trace.finalX = &warmStart;
+        if (!perturbationLPFrequencies(state, graph, config, activeVerts, frequency, &trace)) {
+            warmStart.clear();
+            return;
+        }
+        budgetStats.record("lp[batch]", trace.samples, config.trials);
+        int audited = -1;
+        double delta = 0.0;
+        if (trace.warm && auditWarmStarts) {
+            std::vector<int> coldVerts;
+            std::vector<double> coldFrequency;
+            SolveTrace cold;
+            perturbationLPFrequencies(state, graph, config, coldVerts, coldFrequency, &cold);
+            audited = cold.iterations;
+            for (std::size_t i = 0; i < frequency.size(); ++i) delta += std::fabs(frequency[i] - coldFrequency[i]);
+            delta /= static_cast<double>(frequency.size());
+        }
+        convergenceStats.record(state.depth, trace, audited, delta);
+        for (std::size_t i = 0; i < activeVerts.size(); ++i) {
+            prior[activeVerts[i]] = std::max(config.clampLow, std::min(1.0 - config.clampLow, frequency[i]));
+        }
+    }
+
+    double exactLPSolution(const State& state, const Graph& graph, std::vector<double>& x) {
+        NemhauserTrotter nt(graph.numVertices, graph.adjacencyList, state.possibleVertices);
+        nt.computeMaxMatching();
+        nt.getLPSolution(x);
+        return nt.lpBound();
+    }
+
+    double exactLP(const State& state, const Graph& graph, bool include) {
+        double prob = 0.5;
+
+        const int v = state.actionVertex;
+        if (v >= 0 && v < graph.numVertices && state.possibleVertices.count(v)) {
+            const ExactLPConfig& config = exactLPConfig;
+            NemhauserTrotter nt(graph.numVertices, graph.adjacencyList, state.possibleVertices);
+            double xv = 0.5;
+            if (state.lpMatching) {
+                // Rule 4 fixpoint: its matching is maximum on this residual, and x_v = 1/2
+                nt.setMaxMatching(*state.lpMatching);
+            } else {
+                nt.computeMaxMatching();
+                if (state.lpBound < 0.0) {
+                    // Not a Rule 4 fixpoint: the LP may already decide v
+                    std::vector<double> x;
+                    nt.getLPSolution(x);
+                    xv = x[v];
+                }
+            }
+            if (xv != 0.5) {
+                prob = xv;
+            } else {
+                std::vector<int> closed{v};
+                for (int u : graph.adjacencyList[v]) {
+                    if (state.possibleVertices.count(u)) closed.push_back(u);
+                }
+                const double lbInclude = 1.0 + nt.lpBoundWithout({v});
+                const double lbExclude = static_cast<double>(closed.size() - 1) + nt.lpBoundWithout(closed);
+                prob = 1.0 / (1.0 + std::exp(-config.scale * (lbExclude - lbInclude)));
+            }
+            prob = std::max(config.clampLow, std::min(1.0 - config.clampLow, prob));
+        }
+
+        return include ? prob : 1 - prob;
+    }
+
+    double gibbs(const State& state, const Graph& graph, bool include) {
+        double prob = 0.5;
+
+        const int v = state.actionVertex;
+        if (v >= 0 && v < graph.numVertices && state.possibleVertices.count(v)) {
+            const GibbsConfig& config = gibbsConfig;
+            const int n = static_cast<int>(state.possibleVertices.size());
+            const std::uint64_t seed = 20260401ULL + static_cast<std::uint64_t>(v) * 1009ULL
+                                     + static_cast<std::uint64_t>(n) * 9176ULL;
+            std::vector<int> activeVerts, hits;
+            int sampled = 0;
+            if (!runGibbsChain(state, graph, config, seed, v, activeVerts, hits, sampled, nullptr)) {
+                prob = 0.01; // no edge pressure => typically excluded
+            } else {
+                budgetStats.record("gibbs", sampled, samplesPerChain(config) * std::max(1, config.chains));
+                int actionIdx = static_cast<int>(std::find(activeVerts.begin(), activeVerts.end(), v) - activeVerts.begin());
+                if (sampled > 0) prob = static_cast<double>(hits[actionIdx]) / static_cast<double>(sampled);
+                prob = std::max(config.clampLow, std::min(1.0 - config.clampLow, prob));
+            }
+        }
+
+        return include ? prob : 1 - prob;
+    }
+
+    void gibbsBatch(const State& state, const Graph& graph, std::vector<double>& prior,
+                    std::vector<double>& warmStart) {
+        const GibbsConfig& config = gibbsConfig;
+        const int n = static_cast<int>(state.possibleVertices.size());
+        const std::uint64_t seed = 20260401ULL + static_cast<std::uint64_t>(n) * 9176ULL;
+        std::vector<int> activeVerts, hits;
+        int sampled = 0;
+        SolveTrace trace;
+        trace.warmStart = useWarmStarts ? state.warmStart.get() : nullptr;
+        trace.finalX = &warmStart;
+        if (!runGibbsChain(state, graph, config, seed, -1, activeVerts, hits, sampled, &trace)) {
+            for (int u : state.possibleVertices) prior[u] = 0.01;
+            warmStart.clear();
+            return;
+        }
+        budgetStats.record("gibbs[batch]", sampled, samplesPerChain(config) * std::max(1, config.chains));
+        int audited = -1;
+        double delta = 0.0;
+        if (trace.warm && auditWarmStarts) {
+            std::vector<int> coldVerts, coldHits;
+            int coldSampled = 0;
+            SolveTrace cold;
+            runGibbsChain(state, graph, config, seed, -1, coldVerts, coldHits, coldSampled, &cold);
+            audited = cold.iterations;
+            for (std::size_t i = 0; i < hits.size(); ++i) {
+                delta += std::fabs(static_cast<double>(hits[i]) / sampled - static_cast<double>(coldHits[i]) / coldSampled);
+            }
+            delta /= static_cast<double>(hits.size());
+        }
+        convergenceStats.record(state.depth, trace, audited, delta);
+
+        for (std::size_t i = 0; i < activeVerts.size(); ++i) {
+            double p = sampled > 0 ? static_cast<double>(hits[i]) / static_cast<double>(sampled) : 0.5;
+            prior[activeVerts[i]] = std::max(config.clampLow, std::min(1.0 - config.clampLow, p));
+        }
+    }
+
+    double uniform(const State&, const Graph&, bool) {
+        return 0.5;
+    }
+
+    double perturbationLP(const State& state, const Graph& graph, bool include) {
+        // Perturbation-LP estimator:
+        // Repeatedly solve a perturbed LP relaxation of MVC on the current active core,
+        // then estimate probability by frequency of x_v > 0.5.
+        double prob = 0.5;
+
+        const int v = state.actionVertex;
+        if (v >= 0 && v < graph.numVertices && state.possibleVertices.count(v)) {
+            const PerturbationLPConfig& config = perturbationLPConfig;
+            std::vector<int> activeVerts;
+            std::vector<double> frequency;
+            SolveTrace trace;
+            if (perturbationLPFrequencies(state, graph, config, activeVerts, frequency, &trace, v)) {
+                budgetStats.record("lp", trace.samples, config.trials);
+                int actionIdx = static_cast<int>(std::find(activeVerts.begin(), activeVerts.end(), v) - activeVerts.begin());
+                prob = frequency[actionIdx];
+                prob = std::max(config.clampLow, std::min(1.0 - config.clampLow, prob));
+            }
+        }
+
+        return include ? prob : 1 - prob;
+    }
+
+    double dualPacking(const State& state, const Graph& graph, bool include) {
+        // Approximate LP-dual edge packing y_e with constraints
+        //   sum_{e incident v} y_e <= 1, y_e >= 0
+        // and set p_v proportional to incident dual mass:
+        //   p_v ~ sum_{e incident v} y_e.
+        double prob = 0.5;
+
+        const int v = state.actionVertex;
+        if (v >= 0 && v < graph.numVertices && state.possibleVertices.count(v)) {
+            std::vector<int> activeVerts;
+            activeVerts.reserve(state.possibleVertices.size());
+            std::vector<int> idxOf(graph.numVertices, -1);
+            for (int u : state.possibleVertices) {
+                idxOf[u] = static_cast<int>(activeVerts.size());
+                activeVerts.push_back(u);
+            }
+
+            const int n = static_cast<int>(activeVerts.size());
+            const int actionIdx = idxOf[v];
+            std::vector<std::pair<int, int>> edges;
+            for (int ug : activeVerts) {
+                int u = idxOf[ug];
+                for (int vg : graph.adjacencyList[ug]) {
+                    int w = idxOf[vg];
+                    if (w >= 0 && u < w) edges.push_back({u, w});
+                }
+            }
+
+            if (edges.empty()) {
+                prob = 0.01; // no edge pressure => typically excluded
+            } else {
+                std::vector<double> rem(n, 1.0);     // remaining dual capacity per vertex
+                std::vector<double> load(n, 0.0);    // sum incident y_e per vertex
+
+                // Multiple light passes to reduce order bias
+                constexpr int kPasses = 3;
+                for (int pass = 0; pass < kPasses; ++pass) {
+                    for (const auto& e : edges) {
+                        int a = e.first;
+                        int b = e.second;
+                        if (rem[a] <= 1e-12 || rem[b] <= 1e-12) continue;
+
+                        // Add only a fraction to share capacity across edges
+                        double delta = 0.5 * std::min(rem[a], rem[b]);
+                        rem[a] -= delta;
+                        rem[b] -= delta;
+                        load[a] += delta;
+                        load[b] += delta;
+                    }
+                }
+
+                double maxLoad = 0.0;
+                for (double x : load) maxLoad = std::max(maxLoad, x);
+                if (maxLoad > 1e-12) prob = load[actionIdx] / maxLoad;
+                prob = std::max(0.01, std::min(0.99, prob));
+            }
+        }
+
+        return include ? prob : 1 - prob;
+    }
+
+    bool loadLinearPriorModel(const std::string& path, LinearPriorModel& model) {
+        std::ifstream in(path);
+        if (!in) return false;
+        std::stringstream values;
+        std::string line;
+        while (std::getline(in, line)) values << line.substr(0, line.find('#')) << ' ';
+        LinearPriorModel loaded;
+        for (double& w : loaded.weights) {
+            if (!(values >> w)) return false;
+        }
+        double clampLow;
+        if (values >> clampLow) loaded.clampLow = clampLow;
+        model = loaded;
+        return true;
+    }
+
+    bool saveLinearPriorModel(const std::string& path, const LinearPriorModel& model) {
+        std::ofstream out(path);
+        if (!out) return false;
+        out << "# linear prior: bias, degree, inverse neighbor degree, triangle redundancy, LP value, core number\n";
+        out.precision(17);
+        for (double w : model.weights) out << w << "\n";
+        out << "# clampLow\n" << model.clampLow << "\n";
+        return static_cast<bool>(out);
+    }
+
+    std::shared_ptr<const ResidualStructure> residualStructure(const State& state, const Graph& graph) {
+        std::vector<int> activeVerts(state.possibleVertices.begin(), state.possibleVertices.end());
+        std::sort(activeVerts.begin(), activeVerts.end());
+        ResidualCsr csr;
+        residualCsr(graph, activeVerts, csr);
+        std::vector<double> inverseDegree, redundancy;
+        neighborhoodFeatures(csr, inverseDegree, redundancy);
+        auto structure = std::make_shared<ResidualStructure>();
+        structure->coreNumber.assign(graph.numVertices, 0);
+        structure->inverseDegree.assign(graph.numVertices, 0.0);
+        structure->redundancy.assign(graph.numVertices, 0.0);
+        for (std::size_t i = 0; i < activeVerts.size(); ++i) {
+            structure->coreNumber[activeVerts[i]] = csr.core[i];
+            structure->inverseDegree[activeVerts[i]] = inverseDegree[i];
+            structure->redundancy[activeVerts[i]] = redundancy[i];
+        }
+        structure->maxDegree = csr.maxDeg;
+        structure->maxCore = csr.maxCore;
+        structure->residualSize = activeVerts.size();
+        return structure;
+    }
+
+    void linearFeatures(const State& state, const Graph& graph, std::vector<int>& activeVerts,
+                        std::vector<double>& features) {
+        activeVerts.assign(state.possibleVertices.begin(), state.possibleVertices.end());
+        std::sort(activeVerts.begin(), activeVerts.end());
+        const int n = static_cast<int>(activeVerts.size());
+        ResidualCsr csr;
+        residualCsr(graph, activeVerts, csr);
+        std::vector<double> inverseDegree, redundancy;
+        neighborhoodFeatures(csr, inverseDegree, redundancy);
+
+        std::vector<double> x;
+        if (state.lpBound < 0.0 && n > 0) exactLPSolution(state, graph, x);
+
+        features.assign(static_cast<std::size_t>(n) * kLinearFeatures, 0.0);
+        for (int i = 0; i < n; ++i) {
+            double* f = &features[static_cast<std::size_t>(i) * kLinearFeatures];
+            f[0] = csr.maxDeg > 0 ? static_cast<double>(csr.deg[i]) / csr.maxDeg : 0.0;
+            f[1] = inverseDegree[i];
+            f[2] = redundancy[i];
+            f[3] = x.empty() ? 0.5 : x[activeVerts[i]];
+            f[4] = csr.maxCore > 0 ? static_cast<double>(csr.core[i]) / csr.maxCore : 0.0;
+        }
+    }
+
+    double linearPriorOf(const LinearPriorModel& model, const double* features) {
+        double z = model.weights[0];
+        for (int k = 0; k < kLinearFeatures; ++k) z += model.weights[k + 1] * features[k];
+        const double p = 1.0 / (1.0 + std::exp(-z));
+        return std::max(model.clampLow, std::min(1.0 - model.clampLow, p));
+    }
+
+    double linearPrior(const State& state, const Graph& graph, bool include) {
+        double prob = 0.5;
+
+        const int v = state.actionVertex;
+        if (v >= 0 && v < graph.numVertices && state.possibleVertices.count(v)) {
+            const LinearPriorModel& model = linearPriorModel;
+            const std::size_t residual = state.possibleVertices.size();
+            if (!state.structure ||
+                static_cast<double>(residual) < linearStructureRefresh * static_cast<double>(state.structure->residualSize)) {
+                state.structure = residualStructure(state, graph);
+            }
+            const ResidualStructure& structure = *state.structure;
+
+            // Only v's own residual degree is current; its neighborhood features are read from the structure
+            int degree = 0;
+            for (int u : graph.adjacencyList[v]) degree += state.possibleVertices.count(u) ? 1 : 0;
+
+            double f[kLinearFeatures];
+            f[0] = structure.maxDegree > 0 ? std::min(1.0, static_cast<double>(degree) / structure.maxDegree) : 0.0;
+            f[1] = structure.inverseDegree[v];
+            f[2] = structure.redundancy[v];
+            f[3] = 0.5;
+            if (model.weights[4] != 0.0 && state.lpBound < 0.0) {
+                std::vector<double> x;
+                exactLPSolution(state, graph, x);
+                f[3] = x[v];
+            }
+            f[4] = structure.maxCore > 0
+                ? std::min(1.0, static_cast<double>(structure.coreNumber[v]) / structure.maxCore) : 0.0;
+            prob = linearPriorOf(model, f);
+        }
+
+        return include ? prob : 1 - prob;
+    }
+
+    void linearPriorBatch(const State& state, const Graph& graph, std::vector<double>& prior,
+                          std::vector<double>& warmStart) {
+        std::vector<int> activeVerts;
+        std::vector<double> features;
+        linearFeatures(state, graph, activeVerts, features);
+        for (std::size_t i = 0; i < activeVerts.size(); ++i) {
+            prior[activeVerts[i]] = linearPriorOf(linearPriorModel, &features[i * kLinearFeatures]);
+        }
+        warmStart.clear();
+    }
+
+    const std::vector<Registered>& registry() {
+        static const std::vector<Registered> entries = {
+            {"lp", perturbationLP, perturbationLPBatch},
+            {"exactlp", exactLP, {}},
+            {"gibbs", gibbs, gibbsBatch},
+            {"dual", dualPacking, {}},
+            {"linear", linearPrior, linearPriorBatch},
+            {"uniform", uniform, [](const State&, const Graph&, std::vector<double>&, std::vector<double>&) {}},
+        };
+        return entries;
+    }
+
+    const Registered* find(const std::string& name) {
+        for (const Registered& entry : registry()) {
+            if (entry.name == name) return &entry;
+        }
+        return nullptr;
+    }
+
+    std::size_t scratchBytes() {
+        return g_scratchBytes.load(std::memory_order_relaxed);
+    }
+}
@@ -0,0 +1,416 @@
+#ifndef ESTIMATOR_HPP
+#define ESTIMATOR_HPP
+
+#include <array>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+#include "utils.hpp"
+
+class WorkStealingPool;
+
+/**
+ * @brief Library implementations of PUCT prior estimators (see puct-stratagy.md).
+ *
+ * Each `double name(const State&, const Graph&, bool include)` function matches the
+ * treePolicy::setEstimatePolicy signature and returns the prior of the include branch
+ * (or its complement when include is false).
+ */
+namespace estimator {
+
+    /**
+     * @brief Counters each thread updates without locking, merged when read.
+     *
+     * A thread registers its own shard on first use, the only step that takes the lock.
+     * forEach() visits every shard under the lock but does not synchronize with the
+     * recording threads, so reports are read between searches (as perf_mcts does).
+     */
+    template <class Shard>
+    class PerThread {
+    public:
+        Shard& local() {
+            thread_local std::vector<std::pair<const PerThread*, Shard*>> mine;
+            for (const auto& entry : mine) {
+                if (entry.first == this) return *entry.second;
+            }
+            std::lock_guard<std::mutex> lock(mutex);
+            shards.push_back(std::make_unique<Shard>());
+            mine.emplace_back(this, shards.back().get());
+            return *shards.back();
+        }
+
+        template <class F>
+        void forEach(F&& f) const {
+            std::lock_guard<std::mutex> lock(mutex);
+            for (const auto& shard : shards) f(*shard);
+        }
+
+        template <class F>
+        void forEach(F&& f) {
+            std::lock_guard<std::mutex> lock(mutex);
+            for (auto& shard : shards) f(*shard);
+        }
+
+    private:
+        mutable std::mutex mutex;
+        std::vector<std::unique_ptr<Shard>> shards;  // never freed before the owner, so `mine` stays valid
+    };
+
+    /**
+     * @brief Sequential stopping of the stochastic estimators (perturbation-LP trials, Gibbs samples).
+     *
+     * After each round of trials the Wilson score interval of the inclusion frequency is
+     * checked; a vertex is decided once the interval excludes 1/2 or is at most halfWidth
+     * wide on either side. Per-vertex calls stop when the action vertex is decided, batch
+     * calls when batchQuorum of the residual is. Budgets never go below the estimator's
+     * minimum nor above its fixed budget. Each estimator config carries its own rule.
+     */
+    struct SequentialStopping {
+        bool enabled = true;
+        double z = 1.645;           // two-sided 90% interval
+        double halfWidth = 0.2;     // decided once the interval is this narrow
+        double batchQuorum = 0.9;   // fraction of residual vertices that must be decided
+    };
+
+    /**
+     * @brief Parameters of the perturbation-LP estimator (strategy #4).
+     */
+    struct PerturbationLPConfig {
+        int trials = 12;        // independent perturbed LP solves (the fixed budget)
+        int minTrials = 4;      // sequential stopping never uses fewer trials
+        SequentialStopping stopping;
+        int iterations = 140;   // projected-gradient steps per solve
+        double lr = 0.03;       // step size
+        double mu = 8.0;        // quadratic penalty on uncovered edges
+        double delta = 0.20;    // amplitude of the cost perturbation
+        double clampLow = 0.05; // returned prior is clipped to [clampLow, 1 - clampLow]
+        int patience = 0;       // stop once the penalty objective has not improved for this many
+                                // iterations (0: always run all iterations)
+        double plateauTolerance = 1e-3; // relative improvement that resets the patience window
+        WorkStealingPool* pool = nullptr; // optional: lane blocks run across pool workers
+    };
+
+    /**
+     * @brief Whether `hits` out of `trials` decides the inclusion frequency (see SequentialStopping).
+     */
+    bool wilsonDecided(int hits, int trials, const SequentialStopping& rule);
+
+    /**
+     * @brief Trials (LP) or samples (Gibbs) used against the fixed budget, per estimator.
+     */
+    class BudgetStats {
+    public:
+        struct Row {
+            std::string estimator;
+            long long calls = 0;
+            long long earlyCalls = 0;   // stopped before the fixed budget
+            long long used = 0;
+            long long budget = 0;
+        };
+
+        // `estimator` is a string literal; each thread matches it by pointer
+        void record(const char* estimator, int used, int budget);
+        std::vector<Row> rows() const;
+        void reset();
+
+    private:
+        using Shard = std::vector<std::pair<const char*, Row>>;
+        PerThread<Shard> byEstimator;
+    };
+
+    inline BudgetStats budgetStats;
+
+    /**
+     * @brief Warm-start input and convergence output of one estimator solve.
+     */
+    struct SolveTrace {
+        const std::vector<double>* warmStart = nullptr; // previous final solution (ignored if the layout differs)
+        std::vector<double>* finalX = nullptr;          // receives this solve's final solution
+        bool warm = false;                              // the warm start was used
+        int iterations = 0;                             // iterations to convergence (LP: gradient steps, Gibbs: burn-in)
+        int samples = 0;                                // trials (LP) or samples (Gibbs) counted
+    };
+
+    /**
+     * @brief Configuration used by perturbationLP().
+     */
+    inline PerturbationLPConfig perturbationLPConfig;
+
+    /**
+     * @brief Parameters of the Gibbs estimator (strategy #6): samples vertex covers S from
+     *        P(S) ~ exp(-beta |S|) with single-vertex flips.
+     *
+     * Each chain keeps, per vertex, its number of unselected neighbors, so a removal is
+     * checked in O(1) and a flip costs O(deg).
+     */
+    struct GibbsConfig {
+        double beta = 1.6;      // larger => more mass on smaller covers
+        int burnIn = 400;       // max steps discarded from the all-selected start (per chain)
+        int warmBurnIn = 50;    // max steps discarded when starting from a warm sampler state
+        int samplingSteps = 1800; // steps after burn-in, split over the chains
+        int sampleStride = 6;   // steps between counted samples
+        int minSamples = 150;   // sequential stopping never uses fewer samples (all chains)
+        // Successive samples are correlated, so the interval treats them as samples / sampleCorrelation
+        // independent draws
+        double sampleCorrelation = 8.0;
+        // Off by default: a truncated chain keeps the bias of its start, which costs more calibration
+        // than the saved samples are worth (see README)
+        SequentialStopping stopping{false};
+        double clampLow = 0.01; // returned prior is clipped to [clampLow, 1 - clampLow]
+        int chains = 4;         // independent chains stepped in lockstep (independent loads overlap)
+        bool adaptiveBurnIn = true; // end a chain's burn-in once its acceptance rate settles
+        int burnInWindow = 50;  // steps per acceptance-rate window
+        double acceptanceTolerance = 0.02; // settled: consecutive window rates differ by at most this
+    };
+
+    /**
+     * @brief Configuration used by gibbs() and gibbsBatch().
+     */
+    inline GibbsConfig gibbsConfig;
+
+    /**
+     * @brief Iterations to convergence of the batch estimators, per tree depth.
+     *
+     * Cold solves start from scratch (x = 0.5, all-selected sampler); warm solves start
+     * from the previous solve in the subtree. With auditWarmStarts, every warm solve is
+     * also repeated cold to measure what the warm start saved on that very residual.
+     */
+    class ConvergenceStats {
+    public:
+        struct Row {
+            long long coldSolves = 0;
+            long long coldIterations = 0;
+            long long warmSolves = 0;
+            long long warmIterations = 0;
+            long long auditedColdIterations = 0; // cold repeats of the warm solves (audit only)
+            double auditedPriorDelta = 0.0;      // sum over audited solves of mean |p_warm - p_cold|
+        };
+
+        void record(int depth, const SolveTrace& trace, int auditedColdIterations = -1,
+                    double auditedPriorDelta = 0.0);
+        std::vector<Row> rows() const;
+        void reset();
+
+    private:
+        PerThread<std::vector<Row>> byDepth;
+    };
+
+    inline ConvergenceStats convergenceStats;
+
+    /**
+     * @brief Batch estimators start from state.warmStart when set (default off: on data/small
+     *        warm LP solves took more iterations than cold ones and warm Gibbs priors drifted).
+     */
+    inline bool useWarmStarts = false;
+
+    /**
+     * @brief Repeat every warm batch solve cold to measure the savings (doubles estimator cost).
+     */
+    inline bool auditWarmStarts = false;
+
+    /**
+     * @brief Solves all perturbed LPs on the residual of `state` as one batch.
+     *
+     * Trials are laid out vertex-major with interleaved trials (x[i * lanes + t]) and processed in blocks of
+     * SIMD-width lanes that share one pass over the residual edge list.
+     * @param state State whose possibleVertices define the residual graph.
+     * @param graph The problem graph.
+     * @param config Solver parameters.
+     * @param activeVerts Receives the residual vertices (global ids) in solve order.
+     * @param frequency Receives, per residual vertex, the fraction of trials with x_v > 0.5.
+     * @param trace Optional warm start (x of every trial, indexed x[v * paddedTrials + t]) and
+     *        convergence report; trace->finalX receives this solve's x in the same layout.
+     * @param decideFor With sequentialStopping enabled, lane blocks run in rounds until this
+     *        vertex (-1: a batchQuorum of the residual) is decided; frequencies are then over
+     *        the trials actually run.
+     * @return false if the residual has no edges (nothing was solved).
+     */
+    bool perturbationLPFrequencies(const State& state, const Graph& graph, const PerturbationLPConfig& config,
+                                   std::vector<int>& activeVerts, std::vector<double>& frequency,
+                                   SolveTrace* trace = nullptr, int decideFor = -1);
+
+    /**
+     * @brief Parameters of the exact-LP estimator.
+     */
+    struct ExactLPConfig {
+        double scale = 1.0;     // logistic slope on the branch bound difference
+        double clampLow = 0.05; // returned prior is clipped to [clampLow, 1 - clampLow]
+    };
+
+    /**
+     * @brief Configuration used by exactLP().
+     */
+    inline ExactLPConfig exactLPConfig;
+
+    /**
+     * @brief Exact half-integral LP solution of the residual of `state` (Hopcroft-Karp + König).
+     * @param x Resized to graph.numVertices; x[u] in {0, 0.5, 1} on the residual, 0 elsewhere.
+     * @return LP optimum of the residual.
+     */
+    double exactLPSolution(const State& state, const Graph& graph, std::vector<double>& x);
+
+    /**
+     * @brief Exact-LP prior from the kernelization matching (no gradient iterations).
+     *
+     * If x_v of the exact LP is integral, the prior is x_v. On a Rule 4 fixpoint
+     * (state.lpBound set) every x_v is 1/2, which is known without any work; ties are
+     * then broken by the exact LP bounds of the two branches,
+     * p = sigmoid(scale * (lbExclude - lbInclude)) with lbInclude = 1 + LP(G - v) and
+     * lbExclude = |N(v)| + LP(G - N[v]), both warm-started from one residual matching.
+     */
+    double exactLP(const State& state, const Graph& graph, bool include);
+
+    /**
+     * @brief Uninformed prior (0.5 for both branches); costs nothing per node.
+     */
+    double uniform(const State& state, const Graph& graph, bool include);
+
+    /**
+     * @brief Batch perturbation-LP priors: one solve for every residual vertex
+     *        (treePolicy::BatchEstimatePolicy signature), warm-started from state.warmStart.
+     * @param prior numVertices-sized; residual entries receive the clipped x_v > 0.5 frequency.
+     * @param warmStart Receives the final x of every trial for the next solve in the subtree.
+     */
+    void perturbationLPBatch(const State& state, const Graph& graph, std::vector<double>& prior,
+                             std::vector<double>& warmStart);
+
+    /**
+     * @brief Gibbs prior: fraction of samples containing the action vertex.
+     */
+    double gibbs(const State& state, const Graph& graph, bool include);
+
+    /**
+     * @brief Batch Gibbs priors from one chain; starts from the parent's final sampler
+     *        state (state.warmStart, 0/1 per vertex, repaired to a cover) with the short
+     *        warmBurnIn instead of burnIn.
+     */
+    void gibbsBatch(const State& state, const Graph& graph, std::vector<double>& prior,
+                    std::vector<double>& warmStart);
+
+    /**
+     * @brief Perturbation-LP prior: frequency of x_v > 0.5 for the action vertex over
+     *        perturbationLPConfig.trials perturbed LP solves.
+     */
+    double perturbationLP(const State& state, const Graph& graph, bool include);
+
+    /**
+     * @brief Dual-based prior (strategy #8): greedy fractional edge packing y_e on the
+     *        residual, p_v proportional to the dual mass incident to v.
+     */
+    double dualPacking(const State& state, const Graph& graph, bool include);
+
+    /**
+     * @brief Number of features of the linear prior: residual degree / max residual degree,
+     *        mean inverse residual degree of the neighbors, triangle redundancy (fraction of
+     *        neighbor pairs that are adjacent), exact LP value x_v, core number / max core number.
+     */
+    constexpr int kLinearFeatures = 5;
+
+    /**
+     * @brief Logistic model of the linear prior: p = sigmoid(weights[0] + sum_k weights[k + 1] * f_k).
+     *
+     * The defaults were fitted by `test_estimator --train` on the crown cores of
+     * data/small and data/exact (the LP feature is constant there: every core is a
+     * Rule 4 fixpoint); load others with loadLinearPriorModel().
+     */
+    struct LinearPriorModel {
+        std::array<double, kLinearFeatures + 1> weights = {-2.331, 5.680, -1.016, -1.260, 0.0, 0.323};
+        double clampLow = 0.02; // returned prior is clipped to [clampLow, 1 - clampLow]
+    };
+
+    /**
+     * @brief Model used by linearPrior() and linearPriorBatch().
+     */
+    inline LinearPriorModel linearPriorModel;
+
+    /**
+     * @brief linearPrior() recomputes state.structure once the residual drops below this
+     *        fraction of the residual it was computed on (as priorRefreshRatio; > 1 every call).
+     */
+    inline double linearStructureRefresh = 0.5;
+
+    /**
+     * @brief Max degree, core numbers, mean inverse neighbor degrees and triangle
+     *        redundancies of the residual of `state`.
+     *
+     * O(m) for the degrees and the core decomposition plus O(m sqrt(m)) for the
+     * triangles, as linearFeatures().
+     */
+    std::shared_ptr<const ResidualStructure> residualStructure(const State& state, const Graph& graph);
+
+    /**
+     * @brief Reads a model: kLinearFeatures + 1 whitespace-separated weights (bias first),
+     *        optionally followed by clampLow; '#' starts a comment.
+     * @return false (model untouched) if the file is missing or too short.
+     */
+    bool loadLinearPriorModel(const std::string& path, LinearPriorModel& model);
+
+    /**
+     * @brief Writes a model in the format read by loadLinearPriorModel().
+     */
+    bool saveLinearPriorModel(const std::string& path, const LinearPriorModel& model);
+
+    /**
+     * @brief Features of every residual vertex in one pass over the residual.
+     *
+     * O(m) for degrees, inverse degrees and the core decomposition, plus O(m sqrt(m))
+     * for triangles (listed along degree-ordered edges). x_v is 1/2 on a Rule 4 fixpoint
+     * (state.lpBound set) and comes from exactLPSolution() otherwise.
+     * @param activeVerts Receives the residual vertices in increasing order.
+     * @param features Receives kLinearFeatures values per vertex (features[i * kLinearFeatures + k]).
+     */
+    void linearFeatures(const State& state, const Graph& graph, std::vector<int>& activeVerts,
+                        std::vector<double>& features);
+
+    /**
+     * @brief Logistic prior of one feature row.
+     */
+    double linearPriorOf(const LinearPriorModel& model, const double* features);
+
+    /**
+     * @brief Learned linear prior of the action vertex.
+     *
+     * O(deg(v)) per call: only v's residual degree is counted here. The neighbor degrees,
+     * triangle redundancy, max degree and core number are read from v's row of
+     * state.structure, shared down the tree and refreshed per linearStructureRefresh
+     * (between refreshes they are those of a larger ancestor residual); a refresh costs
+     * as residualStructure(). x_v is only computed, by exactLPSolution(), when its weight
+     * is non-zero.
+     */
+    double linearPrior(const State& state, const Graph& graph, bool include);
+
+    /**
+     * @brief Batch linear priors: one feature pass for every residual vertex.
+     */
+    void linearPriorBatch(const State& state, const Graph& graph, std::vector<double>& prior,
+                          std::vector<double>& warmStart);
+
+    /**
+     * @brief A named estimator; batch is empty when there is no batch version.
+     */
+    struct Registered {
+        std::string name;
+        treePolicy::EstimatePolicy perVertex;
+        treePolicy::BatchEstimatePolicy batch;
+    };
+
+    /**
+     * @brief Every library estimator, in a fixed order (CLI names of the test programs).
+     */
+    const std::vector<Registered>& registry();
+
+    /**
+     * @brief Registry entry by name (nullptr if unknown).
+     */
+    const Registered* find(const std::string& name);
+
+    /**
+     * @brief Bytes held by the per-thread solver scratch of the estimators, summed over
+     *        live threads (pool workers included).
+     */
+    std::size_t scratchBytes();
+}
+
+#endif // ESTIMATOR_HPP
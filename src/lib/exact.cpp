@@ -0,0 +1,110 @@
+#include "exact.hpp"
+#include "bounds.hpp"
+#include "mcts.hpp"
+#include "parallel.hpp"
+#include <algorithm>
+
+namespace {
+    // Branching needs no prior: max-degree vertex, uniform among ties
+    const treePolicy::EstimatePolicy kNoPrior = [](const State&, const Graph&, bool) { return 0.5; };
+
+    // Completes a cover of the residual by repeatedly taking a max-degree vertex (lowest index on ties)
+    std::vector<bool> greedyCover(const Graph& graph, const State& state) {
+        const int n = graph.numVertices;
+        std::vector<bool> cover = state.isSelected;
+        std::vector<int> degree(n, -1);
+        for (int v : state.possibleVertices) {
+            degree[v] = 0;
+            for (int u : graph.adjacencyList[v]) degree[v] += state.possibleVertices.count(u) > 0;
+        }
+        while (true) {
+            int best = -1;
+            for (int v = 0; v < n; ++v) {
+                if (degree[v] > 0 && (best < 0 || degree[v] > degree[best])) best = v;
+            }
+            if (best < 0) break;
+            cover[best] = true;
+            degree[best] = -1;
+            for (int u : graph.adjacencyList[best]) {
+                if (degree[u] > 0) --degree[u];
+            }
+        }
+        return cover;
+    }
+}
+
+BranchAndReduce::BranchAndReduce(const Graph& graph, ExactOptions options)
+    : graph(graph), options(options) {
+    if (options.kernelThreads > 1) kernelPool = std::make_unique<WorkStealingPool>(options.kernelThreads);
+}
+
+BranchAndReduce::~BranchAndReduce() = default;
+
+ExactResult BranchAndReduce::solve() {
+    start = Clock::now();
+    deadline = start + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(options.deadlineSeconds));
+    rng::seedThread(options.seed, 0);
+    result = ExactResult();
+    stopped = false;
+
+    State root(graph.numVertices);
+    while (kernelize(graph, root, graph.numVertices, kernelPool.get()));
+    result.rootKernelSeconds = std::chrono::duration<double>(Clock::now() - start).count();
+    result.rootLowerBound = static_cast<int>(root.selectedVertices.size()) + bounds::residualLowerBound(graph, root);
+
+    // Greedy incumbent, so the bound cuts from the first branch on
+    result.cover = greedyCover(graph, root);
+    result.answer = static_cast<int>(std::count(result.cover.begin(), result.cover.end(), true));
+    result.bestSeconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    search(root, 0);
+    result.optimal = !stopped;
+    result.seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    return result;
+}
+
+bool BranchAndReduce::limitReached() {
+    if (options.maxNodes > 0 && result.nodes >= options.maxNodes) stopped = true;
+    // The clock is read every 64 nodes
+    if (options.deadlineSeconds > 0.0 && (result.nodes & 63) == 0 && Clock::now() >= deadline) stopped = true;
+    return stopped;
+}
+
+void BranchAndReduce::record(const State& state) {
+    const int size = static_cast<int>(state.selectedVertices.size());
+    if (size >= result.answer) return;
+    result.answer = size;
+    result.cover = state.isSelected;
+    result.bestSeconds = std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+void BranchAndReduce::search(State& state, int depth) {
+    ++result.nodes;
+    result.maxDepth = std::max(result.maxDepth, depth);
+    while (kernelize(graph, state, result.answer, kernelPool.get()));
+    if (state.possibleVertices.empty()) {
+        record(state);
+        return;
+    }
+    const int bound = static_cast<int>(state.selectedVertices.size()) + bounds::residualLowerBound(graph, state);
+    if (bound >= result.answer) {
+        ++result.pruned;
+        return;
+    }
+    if (limitReached()) return;
+
+    state.selectActionVertex(graph, kNoPrior);
+    const int v = state.actionVertex;
+    {
+        State include = state;
+        include.include(v);
+        search(include, depth + 1);
+    }
+    if (stopped) return;
+    // The exclude branch reuses this node's state
+    state.exclude(v);
+    for (int u : graph.adjacencyList[v]) {
+        if (state.possibleVertices.count(u)) state.include(u);
+    }
+    search(state, depth + 1);
+}
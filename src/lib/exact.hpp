@@ -0,0 +1,74 @@
+#ifndef EXACT_HPP
+#define EXACT_HPP
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "utils.hpp"
+
+class WorkStealingPool;
+
+/**
+ * @brief Settings of a BranchAndReduce run.
+ */
+struct ExactOptions {
+    double deadlineSeconds = 0.0;       // wall-clock budget (0 = none); the result is then not optimal
+    long long maxNodes = 0;             // search node cap (0 = none)
+    int kernelThreads = 1;              // Rule 4 threads (as MCTS kernelThreads)
+    std::uint64_t seed = rng::kDefaultSeed; // tie-breaking among max-degree branch vertices
+};
+
+/**
+ * @brief Outcome of a BranchAndReduce run.
+ */
+struct ExactResult {
+    int answer = 0;                     // best cover size found
+    std::vector<bool> cover;            // that cover
+    bool optimal = false;               // the search finished (no limit hit), so answer is optimal
+    int rootLowerBound = 0;             // lower bound of the kernelized root
+    long long nodes = 0;                // search nodes visited (root included)
+    long long pruned = 0;               // nodes cut by their lower bound
+    int maxDepth = 0;                   // deepest branching level reached
+    double seconds = 0.0;               // wall time (root kernelization included)
+    double rootKernelSeconds = 0.0;     // kernelization of the root
+    double bestSeconds = 0.0;           // time at which the final answer was found
+};
+
+/**
+ * @brief Exact depth-first branch-and-reduce solver for minimum vertex cover.
+ *
+ * Uses the search space of MCTS: every node is a State reduced with kernelize(), and
+ * branches on a max-degree vertex v into "v in the cover" and "N(v) in the cover", in
+ * that order. A node is cut once |selected| + bounds::residualLowerBound reaches the
+ * incumbent, which starts from a greedy cover of the root. Serves as the exact baseline
+ * for MCTS time-to-optimal.
+ */
+class BranchAndReduce {
+public:
+
+    BranchAndReduce(const Graph& graph, ExactOptions options = ExactOptions());
+    ~BranchAndReduce();
+
+    /**
+     * @brief Solves the instance (see class description); reseeds the calling thread's stream.
+     */
+    ExactResult solve();
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    void search(State& state, int depth);
+    bool limitReached();
+    void record(const State& state);
+
+    const Graph& graph;
+    ExactOptions options;
+    std::unique_ptr<WorkStealingPool> kernelPool;
+    ExactResult result;
+    Clock::time_point start;
+    Clock::time_point deadline;
+    bool stopped = false;
+};
+
+#endif // EXACT_HPP
@@ -0,0 +1,226 @@
+#include "incumbent.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <new>
+#include <thread>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+    constexpr std::uint64_t kMagic = 0x4d4354534d564331ULL; // "MCTSMVC1"
+    constexpr int kLockSpins = 10000;       // give up writing the cover rather than wait on a dead writer
+    constexpr int kAttachWaitMs = 1000;     // how long to wait for another process to initialize
+    constexpr int kReadRetries = 64;
+    constexpr std::size_t kMaxRunIdLength = 64;
+
+    std::string segmentNameFor(const std::string& runId, std::uint64_t hash) {
+        char buf[24];
+        std::snprintf(buf, sizeof(buf), "-%016llx", static_cast<unsigned long long>(hash));
+        return "/mcts-mvc-" + runId + buf;
+    }
+}
+
+// Lives at the start of the mapping; the cover bitmap follows it.
+struct SharedIncumbent::Segment {
+    std::atomic<std::uint64_t> magic;       // stored last by the creator
+    std::uint64_t hash;
+    std::int32_t numVertices;
+    std::int32_t words;
+    std::atomic<std::int32_t> bestSize;     // lowered with CAS; may run ahead of coverSize
+    std::atomic<std::int32_t> coverSize;    // size of the stored cover (seqlock-protected)
+    std::atomic<std::uint32_t> sequence;    // seqlock: odd while a writer copies the cover
+    std::atomic<std::uint32_t> writerLock;
+
+    std::atomic<std::uint64_t>* bits() { return reinterpret_cast<std::atomic<std::uint64_t>*>(this + 1); }
+    const std::atomic<std::uint64_t>* bits() const { return reinterpret_cast<const std::atomic<std::uint64_t>*>(this + 1); }
+};
+
+SharedIncumbent::~SharedIncumbent() {
+    if (!segment) return;
+    if (shared) {
+        munmap(segment, mappedBytes);
+    } else {
+        ::operator delete(static_cast<void*>(segment));
+    }
+}
+
+std::size_t SharedIncumbent::segmentBytes(int numVertices) {
+    std::size_t words = (static_cast<std::size_t>(numVertices) + 63) / 64;
+    return sizeof(Segment) + words * sizeof(std::atomic<std::uint64_t>);
+}
+
+void SharedIncumbent::initialize(Segment* seg, std::uint64_t hash, int numVertices) {
+    new (&seg->magic) std::atomic<std::uint64_t>(0);
+    seg->hash = hash;
+    seg->numVertices = numVertices;
+    seg->words = (numVertices + 63) / 64;
+    new (&seg->bestSize) std::atomic<std::int32_t>(numVertices + 1);
+    new (&seg->coverSize) std::atomic<std::int32_t>(numVertices + 1);
+    new (&seg->sequence) std::atomic<std::uint32_t>(0);
+    new (&seg->writerLock) std::atomic<std::uint32_t>(0);
+    for (int w = 0; w < seg->words; ++w) new (&seg->bits()[w]) std::atomic<std::uint64_t>(0);
+    seg->magic.store(kMagic, std::memory_order_release);
+}
+
+std::uint64_t SharedIncumbent::instanceHash(const Graph& graph) {
+    std::uint64_t h = 1469598103934665603ULL;
+    auto mix = [&h](std::uint64_t value) {
+        for (int b = 0; b < 8; ++b) {
+            h ^= (value >> (8 * b)) & 0xffULL;
+            h *= 1099511628211ULL;
+        }
+    };
+    mix(static_cast<std::uint64_t>(graph.numVertices));
+    for (int u = 0; u < graph.numVertices; ++u) {
+        std::vector<int> nbrs(graph.adjacencyList[u]);
+        std::sort(nbrs.begin(), nbrs.end());
+        for (int v : nbrs) {
+            if (u < v) mix((static_cast<std::uint64_t>(u) << 32) | static_cast<std::uint32_t>(v));
+        }
+    }
+    return h;
+}
+
+bool SharedIncumbent::validRunId(const std::string& runId) {
+    if (runId.empty() || runId.size() > kMaxRunIdLength) return false;
+    return std::all_of(runId.begin(), runId.end(), [](char c) {
+        return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') ||
+               c == '-' || c == '_' || c == '.';
+    });
+}
+
+std::unique_ptr<SharedIncumbent> SharedIncumbent::open(const Graph& graph, const std::string& runId) {
+    if (!validRunId(runId)) return nullptr;
+    const std::uint64_t hash = instanceHash(graph);
+    const std::string name = segmentNameFor(runId, hash);
+    const std::size_t bytes = segmentBytes(graph.numVertices);
+
+    int fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+    const bool creator = fd >= 0;
+    if (!creator) {
+        if (errno != EEXIST) return nullptr;
+        fd = shm_open(name.c_str(), O_RDWR, 0600);
+        if (fd < 0) return nullptr;
+    }
+
+    if (creator) {
+        if (ftruncate(fd, static_cast<off_t>(bytes)) != 0) {
+            close(fd);
+            shm_unlink(name.c_str());
+            return nullptr;
+        }
+    } else {
+        // The creator may not have sized the segment yet
+        struct stat st;
+        for (int waited = 0; ; ++waited) {
+            if (fstat(fd, &st) != 0) { close(fd); return nullptr; }
+            if (static_cast<std::size_t>(st.st_size) == bytes) break;
+            if (st.st_size != 0 || waited >= kAttachWaitMs) { close(fd); return nullptr; }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+
+    void* p = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (p == MAP_FAILED) return nullptr;
+
+    Segment* seg = static_cast<Segment*>(p);
+    if (creator) {
+        initialize(seg, hash, graph.numVertices);
+    } else {
+        int waited = 0;
+        while (seg->magic.load(std::memory_order_acquire) != kMagic && waited++ < kAttachWaitMs) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        if (seg->magic.load(std::memory_order_acquire) != kMagic || seg->hash != hash ||
+            seg->numVertices != graph.numVertices) {
+            munmap(p, bytes);
+            return nullptr;
+        }
+    }
+
+    std::unique_ptr<SharedIncumbent> incumbent(new SharedIncumbent());
+    incumbent->segment = seg;
+    incumbent->mappedBytes = bytes;
+    incumbent->shared = true;
+    incumbent->segmentName = name;
+    return incumbent;
+}
+
+std::unique_ptr<SharedIncumbent> SharedIncumbent::local(int numVertices) {
+    const std::size_t bytes = segmentBytes(numVertices);
+    Segment* seg = static_cast<Segment*>(::operator new(bytes));
+    initialize(seg, 0, numVertices);
+    std::unique_ptr<SharedIncumbent> incumbent(new SharedIncumbent());
+    incumbent->segment = seg;
+    incumbent->mappedBytes = bytes;
+    return incumbent;
+}
+
+bool SharedIncumbent::unlink(const Graph& graph, const std::string& runId) {
+    if (!validRunId(runId)) return false;
+    return shm_unlink(segmentNameFor(runId, instanceHash(graph)).c_str()) == 0;
+}
+
+int SharedIncumbent::bestSize() const {
+    return segment->bestSize.load(std::memory_order_acquire);
+}
+
+bool SharedIncumbent::publish(const std::vector<bool>& cover) {
+    const int size = static_cast<int>(std::count(cover.begin(), cover.end(), true));
+    int current = segment->bestSize.load();
+    do {
+        if (size >= current) return false;
+    } while (!segment->bestSize.compare_exchange_weak(current, size));
+
+    // We won the size; copy the cover unless a better one lands first.
+    int spins = 0;
+    while (segment->writerLock.exchange(1, std::memory_order_acquire)) {
+        if (++spins > kLockSpins) return true;
+        std::this_thread::yield();
+    }
+    if (size < segment->coverSize.load(std::memory_order_relaxed)) {
+        segment->sequence.fetch_add(1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        const int n = std::min<int>(segment->numVertices, static_cast<int>(cover.size()));
+        for (int w = 0; w < segment->words; ++w) {
+            std::uint64_t word = 0;
+            for (int b = 0; b < 64 && w * 64 + b < n; ++b) {
+                if (cover[w * 64 + b]) word |= (1ULL << b);
+            }
+            segment->bits()[w].store(word, std::memory_order_relaxed);
+        }
+        segment->coverSize.store(size, std::memory_order_relaxed);
+        segment->sequence.fetch_add(1, std::memory_order_release);
+    }
+    segment->writerLock.store(0, std::memory_order_release);
+    return true;
+}
+
+int SharedIncumbent::fetch(int knownSize, std::vector<bool>& cover) const {
+    if (bestSize() >= knownSize) return -1;
+    const int n = segment->numVertices;
+    std::vector<std::uint64_t> words(segment->words);
+    for (int attempt = 0; attempt < kReadRetries; ++attempt) {
+        std::uint32_t before = segment->sequence.load(std::memory_order_acquire);
+        if (before & 1U) {
+            std::this_thread::yield();
+            continue;
+        }
+        int size = segment->coverSize.load(std::memory_order_relaxed);
+        if (size >= knownSize) return -1;
+        for (int w = 0; w < segment->words; ++w) words[w] = segment->bits()[w].load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (segment->sequence.load(std::memory_order_relaxed) != before) continue;
+
+        cover.assign(n, false);
+        for (int v = 0; v < n; ++v) cover[v] = (words[v / 64] >> (v % 64)) & 1ULL;
+        return size;
+    }
+    return -1;
+}
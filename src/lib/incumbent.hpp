@@ -0,0 +1,104 @@
+#ifndef INCUMBENT_HPP
+#define INCUMBENT_HPP
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "utils.hpp"
+
+/**
+ * @brief Best known vertex cover shared between solvers of the same instance.
+ *
+ * The segment holds the best cover size (lowered with CAS) and the cover itself as a
+ * bitmap guarded by a seqlock, so readers never block writers. open() maps a POSIX
+ * shared-memory segment named after a run id and the instance hash, letting independent
+ * processes on one host exchange incumbents; local() uses private memory for threads of
+ * one process.
+ *
+ * Lifecycle: the first open() of a (run, instance) pair creates the segment at the trivial
+ * cover, later ones attach to it. Closing a SharedIncumbent only unmaps it; the segment and
+ * its cover stay in /dev/shm until unlink(), so processes that start late in a run still
+ * see the run's best cover. Because of that, every run must use its own run id (a reused id
+ * starts from the previous run's cover), and whoever launched the run calls unlink() for
+ * each instance once all its processes are done.
+ */
+class SharedIncumbent {
+public:
+
+    ~SharedIncumbent();
+
+    SharedIncumbent(const SharedIncumbent&) = delete;
+    SharedIncumbent& operator=(const SharedIncumbent&) = delete;
+
+    /**
+     * @brief Opens (creating on first use) the shared-memory segment of an instance in a run.
+     * @param graph The instance; with runId it names the segment "/mcts-mvc-<runId>-<hash>".
+     * @param runId Identifies the run; letters, digits, '-', '_' and '.' (at most 64).
+     * @return The mapped incumbent, or nullptr if shared memory is unavailable, the run id
+     *         is invalid or the existing segment belongs to a different instance.
+     */
+    static std::unique_ptr<SharedIncumbent> open(const Graph& graph, const std::string& runId);
+
+    /**
+     * @brief Creates a process-private incumbent (same protocol, no shared memory).
+     * @param numVertices Number of vertices of the instance.
+     */
+    static std::unique_ptr<SharedIncumbent> local(int numVertices);
+
+    /**
+     * @brief Removes the shared-memory segment of an instance in a run (existing mappings stay
+     *        valid; a later open() creates a fresh segment).
+     * @return true if a segment was removed.
+     */
+    static bool unlink(const Graph& graph, const std::string& runId);
+
+    /**
+     * @brief Whether runId can name a segment (see open()).
+     */
+    static bool validRunId(const std::string& runId);
+
+    /**
+     * @brief FNV-1a hash of the vertex count and the sorted edge list.
+     */
+    static std::uint64_t instanceHash(const Graph& graph);
+
+    /**
+     * @brief Best cover size published so far (numVertices + 1 if none).
+     */
+    int bestSize() const;
+
+    /**
+     * @brief Publishes a cover if it improves the shared best.
+     * @param cover Selection flags of a complete vertex cover.
+     * @return true if this cover became the shared incumbent.
+     */
+    bool publish(const std::vector<bool>& cover);
+
+    /**
+     * @brief Copies the shared cover if it is smaller than knownSize.
+     * @param knownSize Size of the caller's own incumbent.
+     * @param cover Receives the selection flags of the shared cover.
+     * @return Size of the copied cover, or -1 if nothing better is available yet.
+     */
+    int fetch(int knownSize, std::vector<bool>& cover) const;
+
+    /**
+     * @brief Segment name ("" for local incumbents).
+     */
+    const std::string& name() const { return segmentName; }
+
+private:
+    struct Segment;
+
+    SharedIncumbent() = default;
+    static std::size_t segmentBytes(int numVertices);
+    static void initialize(Segment* segment, std::uint64_t hash, int numVertices);
+
+    Segment* segment = nullptr;
+    std::size_t mappedBytes = 0;
+    bool shared = false;
+    std::string segmentName;
+};
+
+#endif // INCUMBENT_HPP
@@ -1,178 +1,127 @@
 #include "mcts.hpp"
+#include "bounds.hpp"
+#include "crown.hpp"
+#include "estimator.hpp"
+#include "incumbent.hpp"
+#include "parallel.hpp"
+#include "stats.hpp"
 #include <queue>
 #include <limits>
 #include <algorithm>
+#include <chrono>
+#include <climits>
+#include <fstream>
+#include <string>
+#include <unordered_set>
 #include <vector>
+#include <thread>
 
 #include <iostream>
 
 namespace {
-    // Helper class for Hopcroft-Karp algorithm on the bipartite doubling of the graph
-    // to implement Nemhauser-Trotter (Crown) Kernelization.
-    class NemhauserTrotter {
-        int n;
-        const std::vector<std::vector<int>>& adj;
-        const std::unordered_set<int>& possible;
-        
-        // Bipartite matching structures
-        // We model a bipartite graph with Left (0..n-1) and Right (0..n-1).
-        // Edge u-v in G implies edges (u_L, v_R) and (v_L, u_R) in bipartite graph.
-        std::vector<int> pairU; // Left u -> Right v
-        std::vector<int> pairV; // Right v -> Left u
-        std::vector<int> dist;  // For BFS
-
-    public:
-        NemhauserTrotter(int n, const std::vector<std::vector<int>>& adj, const std::unordered_set<int>& possible)
-            : n(n), adj(adj), possible(possible), pairU(n, -1), pairV(n, -1), dist(n) {}
-
-        bool bfs() {
-            std::queue<int> q;
-            int distNIL = std::numeric_limits<int>::max(); 
-
-            for (int u = 0; u < n; ++u) {
-                if (!possible.count(u)) continue;
-                if (pairU[u] == -1) {
-                    dist[u] = 0;
-                    q.push(u);
-                } else {
-                    dist[u] = std::numeric_limits<int>::max();
-                }
-            }
-
-            while (!q.empty()) {
-                int u = q.front();
-                q.pop();
-
-                if (dist[u] < distNIL) {
-                    for (int v : adj[u]) {
-                        if (!possible.count(v)) continue;
-                        // Edge u_L -> v_R
-                        if (pairV[v] == -1) {
-                            if (distNIL == std::numeric_limits<int>::max()) {
-                                distNIL = dist[u] + 1;
-                            }
-                        } else if (dist[pairV[v]] == std::numeric_limits<int>::max()) {
-                            dist[pairV[v]] = dist[u] + 1;
-                            q.push(pairV[v]);
-                        }
-                    }
-                }
-            }
-            return distNIL != std::numeric_limits<int>::max();
-        }
-
-        bool dfs(int u) {
-            if (u != -1) {
-                for (int v : adj[u]) {
-                    if (!possible.count(v)) continue;
-                    if (pairV[v] == -1 || (dist[pairV[v]] == dist[u] + 1 && dfs(pairV[v]))) {
-                        pairV[v] = u;
-                        pairU[u] = v;
-                        return true;
-                    }
-                }
-                dist[u] = std::numeric_limits<int>::max();
-                return false;
-            }
-            return true;
-        }
-
-        void computeMaxMatching() {
-            while (bfs()) {
-                for (int u = 0; u < n; ++u) {
-                    if (possible.count(u) && pairU[u] == -1) {
-                        dfs(u);
-                    }
-                }
-            }
-        }
-
-        void getKernelNodes(std::vector<int>& toInclude, std::vector<int>& toExclude) {
-            computeMaxMatching();
-
-            // Koenig's construction for Min Vertex Cover in Bipartite Graph
-            // Z = Set of vertices reachable from Unmatched_L via alternating paths
-            // MVC = (L \ Z) U (R \cap Z)
-            
-            // 1. Find Z_L and Z_R
-            std::vector<bool> Z_L(n, false);
-            std::vector<bool> Z_R(n, false);
-            std::queue<int> q;
-
-            // Start with unmatched vertices in Left
-            for (int u = 0; u < n; ++u) {
-                if (possible.count(u) && pairU[u] == -1) {
-                    Z_L[u] = true;
-                    q.push(u);
-                }
-            }
-
-            while (!q.empty()) {
-                int u = q.front();
-                q.pop();
-                
-                // u is in L. Traverse edges L->R (non-matching)
-                // In our bipartite check, all edges (u, v) exist.
-                // The edge used in matching is (u, pairU[u]). All others are non-matching.
-                for (int v : adj[u]) {
-                    if (!possible.count(v)) continue;
-                    
-                    // We can only follow non-matching edges from L to R
-                    // If pairU[u] == v, this is a matching edge.
-                    if (pairU[u] == v) continue; 
-
-                    if (!Z_R[v]) {
-                        Z_R[v] = true;
-                        // From v in R, follow matching edge to L (if exists)
-                        if (pairV[v] != -1) {
-                            int w = pairV[v]; // w is in L
-                            if (!Z_L[w]) {
-                                Z_L[w] = true;
-                                q.push(w);
-                            }
-                        }
-                    }
-                }
-            }
+    // Heap payload of a hash set of ints: the bucket array plus one node per element
+    std::size_t hashSetBytes(const std::unordered_set<int>& set) {
+        struct HashNode { void* next; int value; };
+        return set.bucket_count() * sizeof(void*) + set.size() * sizeof(HashNode);
+    }
 
-            // 2. Identify P0 and P1 based on NT Theorem
-            // C_L = { u | !Z_L[u] }
-            // C_R = { v | Z_R[v] }
-            // Include u if matches on both sides: u_L \in C_L AND u_R \in C_R
-            // => !Z_L[u] AND Z_R[u]
-            // Exclude u if matches on neither side: u_L \notin C_L AND u_R \notin C_K
-            // => Z_L[u] AND !Z_R[u]
-
-            for (int u = 0; u < n; ++u) {
-                if (!possible.count(u)) continue;
-                
-                bool inC_L = !Z_L[u];
-                bool inC_R = Z_R[u];
-
-                if (inC_L && inC_R) {
-                    toInclude.push_back(u);
-                } else if (!inC_L && !inC_R) {
-                    toExclude.push_back(u);
-                }
+    // A "<field>: <n> kB" line of /proc/self/status in bytes (0 if unavailable)
+    std::size_t procStatusBytes(const std::string& field) {
+        std::ifstream status("/proc/self/status");
+        std::string line;
+        while (std::getline(status, line)) {
+            if (line.compare(0, field.size() + 1, field + ":") == 0) {
+                return static_cast<std::size_t>(std::stoull(line.substr(field.size() + 1))) * 1024;
             }
         }
-    };
+        return 0;
+    }
 }
 
-MCTS::MCTS(Graph& graph, double explorationParam)
+MCTS::MCTS(Graph& graph, double explorationParam, int kernelThreads, std::uint64_t seed,
+           treePolicy::EstimatePolicy estimator)
     : root(new Node())
     , graph(graph)
-    , explorationParam(explorationParam) {
+    , seed(seed)
+    , explorationParam(explorationParam)
+    , estimatePolicy(std::move(estimator)) {
+    // Counters left on this thread by earlier work are not this tree's
+    MCTS_STATS_RESET();
+    rng::seedThread(seed, 0);
+    if (kernelThreads > 1) kernelPool = std::make_unique<WorkStealingPool>(kernelThreads);
     root->state = State(graph.numVertices);
     answer = graph.numVertices; // Initial worst-case answer
-    while (this->kernelization(root));
-    if (!root->state.selectActionVertex(this->graph)) {
+    bestCoverSize = graph.numVertices + 1;
+    {
+        MCTS_STATS_SCOPE(Kernelize);
+        while (this->kernelization(root));
+    }
+    updateLowerBound(root->state);
+    root->bound = root->state.lowerBound;
+    initRoot();
+    flushStats();
+}
+
+MCTS::MCTS(Graph& graph, const State& kernelizedRoot, double explorationParam, int kernelThreads, std::uint64_t seed,
+           treePolicy::EstimatePolicy estimator)
+    : root(new Node())
+    , graph(graph)
+    , seed(seed)
+    , explorationParam(explorationParam)
+    , estimatePolicy(std::move(estimator)) {
+    MCTS_STATS_RESET();
+    rng::seedThread(seed, 0);
+    if (kernelThreads > 1) kernelPool = std::make_unique<WorkStealingPool>(kernelThreads);
+    root->state = kernelizedRoot;
+    answer = graph.numVertices;
+    bestCoverSize = graph.numVertices + 1;
+    updateLowerBound(root->state);
+    root->bound = root->state.lowerBound;
+    initRoot();
+    flushStats();
+}
+
+void MCTS::initRoot() {
+    if (!selectAction(root->state)) {
         answer = std::count(root->state.isSelected.begin(), root->state.isSelected.end(), true);
+        history.push_back({std::chrono::steady_clock::now(), answer});
+        bestCover = root->state.isSelected;
+        bestCoverSize = answer;
         root->expandable = 0;
         expandableUpdate(root);
     }
 }
 
+const treePolicy::EstimatePolicy& MCTS::activeEstimatePolicy() const {
+    return estimatePolicy ? estimatePolicy : treePolicy::estimatePolicy;
+}
+
+bool MCTS::selectAction(State& state) const {
+    MCTS_STATS_SCOPE(Estimator);
+    if (batchEstimatePolicy) {
+        return state.selectActionVertex(this->graph, batchEstimatePolicy, treePolicy::priorRefreshRatio);
+    }
+    if (!estimatePolicy && treePolicy::batchEstimatePolicy) {
+        return state.selectActionVertex(this->graph, treePolicy::batchEstimatePolicy, treePolicy::priorRefreshRatio);
+    }
+    return state.selectActionVertex(this->graph, activeEstimatePolicy());
+}
+
+void MCTS::setBatchEstimatePolicy(treePolicy::BatchEstimatePolicy policy) {
+    batchEstimatePolicy = std::move(policy);
+    if (root->state.actionVertex >= 0 && root->children.empty()) {
+        root->state.priors.reset();
+        selectAction(root->state);
+    }
+}
+
+void MCTS::setEstimatePolicy(treePolicy::EstimatePolicy policy) {
+    estimatePolicy = std::move(policy);
+    if (root->state.actionVertex >= 0 && root->children.empty()) {
+        root->state.estProbInclude = activeEstimatePolicy()(root->state, this->graph, true);
+    }
+}
+
 MCTS::~MCTS() {
     delete root;
 }
@@ -181,69 +130,177 @@ void MCTS::setExplorationParam(double param) {
     this->explorationParam = param;
 }
 
+bool MCTS::updateAnswer(int coverSize) {
+    int current = answer.load();
+    while (coverSize < current) {
+        if (answer.compare_exchange_weak(current, coverSize)) {
+            const auto now = std::chrono::steady_clock::now();
+            std::lock_guard<std::mutex> lock(historyMutex);
+            history.push_back({now, coverSize});
+            return true;
+        }
+    }
+    return false;
+}
+
+bool MCTS::updateIncumbent(const std::vector<bool>& cover) {
+    const int size = static_cast<int>(std::count(cover.begin(), cover.end(), true));
+    bool improved = updateAnswer(size);
+    if (improved) {
+        std::lock_guard<std::mutex> lock(incumbentMutex);
+        // A concurrent worker may have stored an even better cover meanwhile
+        if (size < bestCoverSize) {
+            bestCover = cover;
+            bestCoverSize = size;
+        }
+    }
+    if (improved && sharedIncumbent) sharedIncumbent->publish(cover);
+    return improved;
+}
+
+void MCTS::setSharedIncumbent(SharedIncumbent* incumbent) {
+    sharedIncumbent = incumbent;
+    if (!sharedIncumbent) return;
+    {
+        std::lock_guard<std::mutex> lock(incumbentMutex);
+        if (!bestCover.empty()) sharedIncumbent->publish(bestCover);
+    }
+    syncIncumbent();
+}
+
+bool MCTS::syncIncumbent() {
+    if (!sharedIncumbent || sharedIncumbent->bestSize() >= answer) return false;
+    std::vector<bool> cover;
+    int size = sharedIncumbent->fetch(answer, cover);
+    if (size < 0 || !updateAnswer(size)) return false;
+    std::lock_guard<std::mutex> lock(incumbentMutex);
+    if (size < bestCoverSize) {
+        bestCover = std::move(cover);
+        bestCoverSize = size;
+    }
+    return true;
+}
+
+void MCTS::updateLowerBound(State& state) const {
+    MCTS_STATS_SCOPE(Bound);
+    const int bound = static_cast<int>(state.selectedVertices.size()) + bounds::residualLowerBound(this->graph, state);
+    state.lowerBound = std::max(state.lowerBound, bound);
+}
+
+bool MCTS::prune(Node* node) {
+    if (!pruning || node->bound < answer.load(std::memory_order_relaxed)) return false;
+    // Whoever takes expandable to 0 propagates, as in expandableUpdate
+    if (node->expandable.exchange(0) > 0) {
+        recordPrune(node->state.depth);
+        expandableUpdate(node);
+    }
+    return true;
+}
+
+void MCTS::propagateBound(Node* node) {
+    for (; node && node->full(); node = node->parent) {
+        const int childBound = std::min(node->children[0]->bound.load(), node->children[1]->bound.load());
+        if (!node->raiseBound(childBound)) return;
+    }
+}
+
+void MCTS::recordPrune(int depth) {
+    std::lock_guard<std::mutex> lock(pruneMutex);
+    if (static_cast<int>(prunes.size()) <= depth) prunes.resize(depth + 1, 0);
+    ++prunes[depth];
+}
+
+std::vector<long long> MCTS::prunedPerDepth() const {
+    std::lock_guard<std::mutex> lock(pruneMutex);
+    return prunes;
+}
+
+std::vector<AnswerImprovement> MCTS::answerHistory() const {
+    std::lock_guard<std::mutex> lock(historyMutex);
+    return history;
+}
+
 void MCTS::expandableUpdate(Node* node) {
-    while (node->expandable == 0) {
+    while (node->parent) {
+        // Only the worker that takes the parent from 1 to 0 continues upward.
+        if (node->parent->expandable.fetch_sub(1) != 1) return;
         node = node->parent;
-        if (!node) return;
-        node->expandable--;
     }
 }
 
-bool MCTS::kernelization(Node* node) {
+bool kernelize(const Graph& graph, State& state, int answer, WorkStealingPool* pool, KernelStats* stats) {
     // Rule 1: If there is a vertex of degree 0, remove it from the graph (no need to select it)
-    for (int v = 0; v < this->graph.numVertices; ++v) {
-        // Consider only vertices that are still possible to act on and not already selected
-        if (node->state.possibleVertices.count(v)) {
-            int degree = 0;
-            for (int u : this->graph.adjacencyList[v]) {
-                // Degree counts only neighbors that are also still possible and not selected
-                if (node->state.possibleVertices.count(u)) {
-                    degree++;
+    {
+        MCTS_STATS_SCOPE(Rule1);
+        for (int v = 0; v < graph.numVertices; ++v) {
+            // Consider only vertices that are still possible to act on and not already selected
+            if (state.possibleVertices.count(v)) {
+                int degree = 0;
+                for (int u : graph.adjacencyList[v]) {
+                    // Degree counts only neighbors that are also still possible and not selected
+                    if (state.possibleVertices.count(u)) {
+                        degree++;
+                    }
+                }
+                if (degree == 0) {
+                    // Remove vertex v from the remaining graph (make it impossible to select)
+                    state.exclude(v);
+                    MCTS_STATS_REMOVED(Rule1, 1);
+                    return true;
                 }
-            }
-            if (degree == 0) {
-                // Remove vertex v from the remaining graph (make it impossible to select)
-                node->state.exclude(v);
-                return true;
             }
         }
     }
 
     // Rule 2: If there is a vertex of degree 1, select its neighbor
-    for (int v = 0; v < this->graph.numVertices; ++v) {
-        if (node->state.possibleVertices.count(v)) {
-            int degree = 0;
-            int neighbor = -1;
-            for (int u : this->graph.adjacencyList[v]) {
-                if (node->state.possibleVertices.count(u)) {
-                    degree++;
-                    neighbor = u;
+    {
+        MCTS_STATS_SCOPE(Rule2);
+        for (int v = 0; v < graph.numVertices; ++v) {
+            if (state.possibleVertices.count(v)) {
+                int degree = 0;
+                int neighbor = -1;
+                for (int u : graph.adjacencyList[v]) {
+                    if (state.possibleVertices.count(u)) {
+                        degree++;
+                        neighbor = u;
+                    }
                 }
-            }
-            if (degree == 1 && neighbor != -1) {
-                // Select the neighbor vertex (only if it's still possible)
-                if (node->state.possibleVertices.count(neighbor)) {
-                    node->state.include(neighbor);
-                    return true;
+                if (degree == 1 && neighbor != -1) {
+                    // Select the neighbor vertex (only if it's still possible)
+                    if (state.possibleVertices.count(neighbor)) {
+                        state.include(neighbor);
+                        MCTS_STATS_REMOVED(Rule2, 1);
+                        return true;
+                    }
                 }
             }
         }
     }
 
-    // Rule 3: If there is a vertex with degree greater than k (where k is the size of the current solution), select it
-    int k = answer;
-    for (int v = 0; v < this->graph.numVertices; ++v) {
-        if (node->state.possibleVertices.count(v)) {
-            int degree = 0;
-            for (int u : this->graph.adjacencyList[v]) {
-                if (node->state.possibleVertices.count(u)) {
-                    degree++;
+    // Rule 3: Only covers smaller than the answer matter, so at most k = answer - |selected| - 1 more
+    // vertices can be taken; a vertex with more than k residual neighbors must be one of them.
+    // k < 0: nothing here can improve (left to the lower bound)
+    const int k = answer - static_cast<int>(state.selectedVertices.size()) - 1;
+    {
+        MCTS_STATS_SCOPE(Rule3);
+        for (int v = 0; k >= 0 && v < graph.numVertices; ++v) {
+            if (state.possibleVertices.count(v)) {
+                int degree = 0;
+                for (int u : graph.adjacencyList[v]) {
+                    if (state.possibleVertices.count(u)) {
+                        degree++;
+                    }
+                }
+                if (degree > k) {
+                    // Select vertex v
+                    state.include(v);
+                    MCTS_STATS_REMOVED(Rule3, 1);
+                    if (stats) {
+                        stats->rule3.fetch_add(1, std::memory_order_relaxed);
+                        if (degree <= answer) stats->rule3Extra.fetch_add(1, std::memory_order_relaxed);
+                    }
+                    return true;
                 }
-            }
-            if (degree > k) {
-                // Select vertex v
-                node->state.include(v);
-                return true;
             }
         }
     }
@@ -258,21 +315,30 @@ bool MCTS::kernelization(Node* node) {
     
     // Only run this expensive reduction if simpler rules failed and graph is reasonably sized
     // or if we want strong pruning.
-    if (node->state.possibleVertices.size() > 0) {
-        NemhauserTrotter nt(this->graph.numVertices, this->graph.adjacencyList, node->state.possibleVertices);
+    if (state.possibleVertices.size() > 0) {
+        MCTS_STATS_SCOPE(Rule4);
+        NemhauserTrotter nt(graph.numVertices, graph.adjacencyList, state.possibleVertices, pool);
         std::vector<int> toInclude, toExclude;
         nt.getKernelNodes(toInclude, toExclude);
 
         if (!toInclude.empty() || !toExclude.empty()) {
-            for (int u : toInclude) node->state.include(u);
-            for (int u : toExclude) node->state.exclude(u);
+            for (int u : toInclude) state.include(u);
+            for (int u : toExclude) state.exclude(u);
+            MCTS_STATS_REMOVED(Rule4, toInclude.size() + toExclude.size());
             return true;
         }
+        // Fixpoint: the matching is the exact LP optimum of this residual (all x_v = 1/2)
+        state.lpBound = nt.lpBound();
+        state.lpMatching = std::make_shared<const std::vector<std::pair<int, int>>>(nt.matchedPairs());
     }
 
     return false;
 }
 
+bool MCTS::kernelization(Node* node) {
+    return kernelize(this->graph, node->state, answer, kernelPool.get(), &kernelStats);
+}
+
 State MCTS::getSolution() {
     Node* node = root;
     // Traverse down while there are children; pick the best each step
@@ -290,36 +356,172 @@ State MCTS::getSolution() {
 }
 
 void MCTS::run() {
-    Node* leaf = this->select(root);
+    // Descents that end at a node closed by its bound are retried
+    while (!optimal() && !this->iterate());
+}
+
+bool MCTS::iterate() {
+#ifdef MCTS_STATS
+    // This thread's counters reach the tree's totals however the attempt ends
+    struct Flush { MCTS* tree; ~Flush() { tree->flushStats(); } } flush{this};
+#endif
+    // Other solvers' incumbents tighten Rule 3 for the nodes we build next
+    this->syncIncumbent();
+    Node* leaf;
+    {
+        MCTS_STATS_SCOPE(Select);
+        leaf = this->select(root);
+    }
+    if (!leaf) return false;
     Node* child = this->expand(leaf);
-    double reward = -this->simulate(child).selectedVertices.size();
-    this->backpropagate(child, reward);
+    if (!child) return false;
+    // A dominated child cannot improve the answer: its bound stands in for the rollout
+    double reward;
+    if (pruning && child->bound >= answer) {
+        reward = -static_cast<double>(child->bound);
+    } else {
+        MCTS_STATS_SCOPE(Rollout);
+        reward = -static_cast<double>(this->simulate(child).selectedVertices.size());
+    }
+    {
+        MCTS_STATS_SCOPE(Backpropagate);
+        this->backpropagate(child, reward);
+    }
+    iterationCount.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+stats::SearchStats MCTS::stats() const {
+    std::lock_guard<std::mutex> lock(statsMutex);
+    stats::SearchStats totals = statsTotals;
+    totals.iterations = iterationCount.load();
+    return totals;
+}
+
+MemoryReport MCTS::memoryReport() const {
+    MemoryReport report;
+    std::unordered_set<const void*> tables;  // prior tables shared by several states count once
+    std::vector<const Node*> stack{root};
+    while (!stack.empty()) {
+        const Node* node = stack.back();
+        stack.pop_back();
+        const State& state = node->state;
+        ++report.nodes;
+        report.nodeBytes += sizeof(Node);
+        report.bitsetBytes += (state.isSelected.capacity() + CHAR_BIT - 1) / CHAR_BIT;
+        report.hashSetBytes += hashSetBytes(state.selectedVertices) + hashSetBytes(state.possibleVertices);
+        for (const auto* table : {state.priors.get(), state.warmStart.get()}) {
+            if (table && tables.insert(table).second) report.priorTableBytes += table->capacity() * sizeof(double);
+        }
+        const auto* matching = state.lpMatching.get();
+        if (matching && tables.insert(matching).second) {
+            report.priorTableBytes += matching->capacity() * sizeof(std::pair<int, int>);
+        }
+        const auto* structure = state.structure.get();
+        if (structure && tables.insert(structure).second) {
+            report.priorTableBytes += sizeof(ResidualStructure) + structure->coreNumber.capacity() * sizeof(int)
+                + (structure->inverseDegree.capacity() + structure->redundancy.capacity()) * sizeof(double);
+        }
+        for (Node* child : node->children) stack.push_back(child);
+    }
+    report.graphBytes = graph.adjacencyList.capacity() * sizeof(std::vector<int>);
+    for (const std::vector<int>& neighbors : graph.adjacencyList) report.graphBytes += neighbors.capacity() * sizeof(int);
+    report.estimatorScratchBytes = estimator::scratchBytes();
+    report.rssBytes = procStatusBytes("VmRSS");
+    report.peakRssBytes = procStatusBytes("VmHWM");
+    return report;
+}
+
+void MCTS::flushStats() {
+#ifdef MCTS_STATS
+    const stats::SearchStats local = stats::take();
+    std::lock_guard<std::mutex> lock(statsMutex);
+    statsTotals.merge(local);
+#endif
+}
+
+void MCTS::runParallel(int iterations, int numThreads, Placement placement, double deadlineSeconds) {
+    using Clock = std::chrono::steady_clock;
+    const auto deadline = Clock::now() + std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<double>(deadlineSeconds));
+    auto inTime = [&]() { return deadlineSeconds <= 0.0 || Clock::now() < deadline; };
+    if (numThreads <= 1) {
+        for (int it = 0; it < iterations && !optimal() && inTime(); ++it) this->run();
+        return;
+    }
+
+    std::atomic<int> remaining(iterations);
+    const std::uint64_t firstStream = nextStream.fetch_add(numThreads - 1);
+    auto worker = [&]() {
+        while (!optimal() && inTime() && remaining.fetch_sub(1) > 0) {
+            // Abandoned attempts (lost races) do not consume an iteration.
+            while (!optimal() && !this->iterate());
+        }
+    };
+
+    // Within the caller's affinity mask, so a caller restricted to a slice keeps its tree there
+    const std::vector<int> callerAffinity = placement == Placement::None
+        ? std::vector<int>() : CpuTopology::currentAffinity();
+    const std::vector<int> cpus =
+        CpuTopology::host().placement(numThreads, placement, CpuTopology::currentCpu(), callerAffinity);
+    if (!cpus.empty()) CpuTopology::pinCurrentThread(cpus[0]);
+
+    std::vector<std::thread> threads;
+    threads.reserve(numThreads - 1);
+    for (int t = 1; t < numThreads; ++t) {
+        threads.emplace_back([&, t]() {
+            // Pinned before the first expand, so this worker's nodes are first-touched on its node
+            if (!cpus.empty()) CpuTopology::pinCurrentThread(cpus[t]);
+            rng::seedThread(seed, firstStream + t - 1);
+            worker();
+        });
+    }
+    worker();
+    for (std::thread& th : threads) th.join();
+    if (!cpus.empty()) CpuTopology::setCurrentAffinity(callerAffinity);
 }
 
 Node* MCTS::select(Node* node) {
+    // A concurrent worker may have exhausted this subtree after our parent chose it.
+    if (node->expandable <= 0) return nullptr;
+    // The answer may have dropped to this node's bound since it was built
+    if (prune(node)) return nullptr;
     if (!node->full()) return node;
-    assert(node->expandable > 0 && "Node is fully expanded but marked expandable");
+    // Other workers filled both slots while this node's own rollout is still in flight;
+    // the tree policies need a visit count, so retry from the root
+    if (node->visits == 0) return nullptr;
     if (node->expandable == 1) {
         assert(node->children.size() == 2);
         if (node->children[0]->expandable > 0) return select(node->children[0]);
         else return select(node->children[1]);
     }
-    // return select(treePolicy::uctSampling(node, this->explorationParam));
-    return select(treePolicy::epsilonGreedy(node, this->explorationParam));
-    // return select(treePolicy::puctArgmax(node, this->graph, this->explorationParam));
+    switch (selectionPolicy) {
+        case SelectionPolicy::Uct:
+            return select(treePolicy::uctSampling(node, this->explorationParam));
+        case SelectionPolicy::Puct:
+            return select(treePolicy::puctArgmax(node, this->graph, this->explorationParam));
+        case SelectionPolicy::EpsilonGreedy:
+        default:
+            return select(treePolicy::epsilonGreedy(node, this->explorationParam));
+    }
 }
 
 Node* MCTS::expand(Node* node) {
-    assert(node->expandable > 0 && "Cannot expand a fully expanded node");
     // assert(node->state.actionEdge.first != -1 && "No valid action edge to expand on");
     assert(node->state.actionVertex != -1 && "No valid action vertex to expand on");
+    MCTS_STATS_SCOPE(Expand);
+
+    // Slots fill in order, so the first empty slot is the branch to build.
+    const std::size_t slot = node->children.size();
+    if (slot >= ChildSlots::kCapacity) return nullptr;
 
     Node *child = new Node();
     child->state = node->state;
+    child->state.depth = node->state.depth + 1;
     child->parent = node;
     // child->state.include(node->state.actionEdge.first);
     // if (node->children.size() == 1) { child->state.exclude(node->state.actionEdge.second); }
-    if (node->children.size() == 0) {
+    if (slot == 0) {
         child->state.include(node->state.actionVertex);
     } else {
         child->state.exclude(node->state.actionVertex);
@@ -327,13 +529,27 @@ Node* MCTS::expand(Node* node) {
             if (child->state.possibleVertices.count(v) > 0) child->state.include(v);
         }
     }
-    while (this->kernelization(child));
+    {
+        MCTS_STATS_SCOPE(Kernelize);
+        while (this->kernelization(child));
+    }
+    updateLowerBound(child->state);
     // if (!child->state.selectActionEdge(this->graph)) { 
-    if (!child->state.selectActionVertex(this->graph)) {
-        child->expandable = 0;
-        expandableUpdate(child);
+    // A dominated child is closed before its (possibly costly) action selection
+    child->bound = child->state.lowerBound;
+    const bool pruned = pruning && child->bound >= answer;
+    if (pruned) child->state.actionVertex = -1;
+    const bool terminal = pruned || !selectAction(child->state);
+    if (terminal) child->expandable = 0;
+    if (!node->tryAddChild(slot, child)) {
+        // Another worker published this branch first; roll out from its child.
+        delete child;
+        return node->children[slot];
     }
-    node->addChild(child);
+    nodeCount.fetch_add(1, std::memory_order_relaxed);
+    if (pruned) recordPrune(child->state.depth);
+    if (terminal) expandableUpdate(child);
+    propagateBound(node);
 
     // std::swap(node->state.actionEdge.first, node->state.actionEdge.second);
 
@@ -383,8 +599,18 @@ State MCTS::simulate(Node* node) {
         }
         // pick argmax deg among not-yet-selected
         int w = -1, best = -1;
-        for (int i = 0; i < n; ++i) {
-            if (!sel[i] && deg[i] > best) { best = deg[i]; w = i; }
+        if (rolloutPolicy == RolloutPolicy::RandomizedGreedy) {
+            // Reservoir-sample one of the tied maxima
+            int ties = 0;
+            for (int i = 0; i < n; ++i) {
+                if (sel[i] || deg[i] < best) continue;
+                if (deg[i] > best) { best = deg[i]; ties = 0; }
+                if (rng::uniformIndex(++ties) == 0) w = i;
+            }
+        } else {
+            for (int i = 0; i < n; ++i) {
+                if (!sel[i] && deg[i] > best) { best = deg[i]; w = i; }
+            }
         }
         if (w == -1) {
             // fallback: pick any unselected vertex
@@ -394,7 +620,7 @@ State MCTS::simulate(Node* node) {
         sel[w] = true;
     }
 
-    answer = std::min(answer, static_cast<int>(std::count(sel.begin(), sel.end(), true)));
+    updateIncumbent(sel);
 
     return State(sel);
 
@@ -1,16 +1,114 @@
 #ifndef MCTS_HPP
 #define MCTS_HPP
 
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <vector>
 #include "node.hpp"
+#include "stats.hpp"
+#include "topology.hpp"
 #include "utils.hpp"
 
 /**
  * @brief Class implementing the Monte Carlo Tree Search algorithm.
  */
+class SharedIncumbent;
+class WorkStealingPool;
+
+/**
+ * @brief Child selection rule applied by MCTS::select at full nodes.
+ */
+enum class SelectionPolicy { EpsilonGreedy, Uct, Puct };
+
+/**
+ * @brief Completion rule used by MCTS::simulate.
+ */
+enum class RolloutPolicy {
+    Greedy,             // max residual degree, lowest index on ties
+    RandomizedGreedy    // max residual degree, uniform among ties
+};
+
+/**
+ * @brief One improvement of MCTS::answer: when it happened and the new answer.
+ */
+struct AnswerImprovement {
+    std::chrono::steady_clock::time_point time;
+    int answer;
+};
+
+/**
+ * @brief Counters of kernelize() (shared by concurrent workers).
+ */
+struct KernelStats {
+    std::atomic<long long> rule3{0};        // Rule 3 inclusions
+    std::atomic<long long> rule3Extra{0};   // of which the global bound (degree > answer) would have missed
+};
+
+/**
+ * @brief Memory held by a search tree (MCTS::memoryReport()).
+ *
+ * Heap sizes are allocated payload (capacities, hash buckets and hash nodes) without
+ * allocator headers; the process RSS figures include those and everything else.
+ */
+struct MemoryReport {
+    long long nodes = 0;                    // tree nodes walked (root included)
+    std::size_t nodeBytes = 0;              // sizeof(Node) per node (inline State members included)
+    std::size_t bitsetBytes = 0;            // State::isSelected
+    std::size_t hashSetBytes = 0;           // State::selectedVertices and possibleVertices
+    std::size_t priorTableBytes = 0;        // prior, warm-start, LP matching and structure tables (shared ones once)
+    std::size_t graphBytes = 0;             // the tree's copy of the graph
+    std::size_t estimatorScratchBytes = 0;  // estimator::scratchBytes() (process-wide)
+    std::size_t rssBytes = 0;               // VmRSS of the process (0 if unavailable)
+    std::size_t peakRssBytes = 0;           // VmHWM of the process (0 if unavailable)
+
+    /**
+     * @brief Bytes that grow with the tree: nodes, their states and prior tables.
+     */
+    std::size_t treeBytes() const { return nodeBytes + bitsetBytes + hashSetBytes + priorTableBytes; }
+
+    /**
+     * @brief treeBytes() per node.
+     */
+    double bytesPerNode() const { return nodes > 0 ? static_cast<double>(treeBytes()) / nodes : 0.0; }
+};
+
+/**
+ * @brief Applies the first reduction rule that fires to a state (see MCTS::kernelization).
+ *
+ * Rule 1 excludes isolated vertices, Rule 2 includes the neighbor of a degree-1 vertex,
+ * Rule 3 includes a vertex of degree > answer - |selected| - 1 (only covers smaller than
+ * the answer are sought), and Rule 4 (Nemhauser-Trotter) includes / excludes the LP-forced
+ * vertices; at the Rule 4 fixpoint state.lpBound is recorded.
+ * @param answer Size of the best known cover (bounds Rule 3).
+ * @param pool Optional pool for the parallel Rule 4 matching.
+ * @param stats Optional counters.
+ * @return true if a reduction was applied (call until false for the fixpoint).
+ */
+bool kernelize(const Graph& graph, State& state, int answer, WorkStealingPool* pool = nullptr,
+               KernelStats* stats = nullptr);
+
 class MCTS {
 public:
 
-    MCTS(Graph& graph, double explorationParam = 0.0);
+    /**
+     * @param graph The problem graph (copied).
+     * @param explorationParam Exploration parameter for the tree policy.
+     * @param kernelThreads Threads for the Rule 4 matching on large residuals (1 = sequential).
+     * @param seed Seed of the random streams; the constructing thread is reseeded to stream 0.
+     * @param estimator Initial estimatePolicy (empty: the global one); the root action is
+     *        picked with it, so no setEstimatePolicy() re-estimate is needed.
+     */
+    MCTS(Graph& graph, double explorationParam = 0.0, int kernelThreads = 1,
+         std::uint64_t seed = rng::kDefaultSeed, treePolicy::EstimatePolicy estimator = {});
+
+    /**
+     * @brief Starts from an already kernelized root state (e.g. shared by a portfolio).
+     * @param kernelizedRoot Root state; no reduction is applied to it again.
+     */
+    MCTS(Graph& graph, const State& kernelizedRoot, double explorationParam = 0.0, int kernelThreads = 1,
+         std::uint64_t seed = rng::kDefaultSeed, treePolicy::EstimatePolicy estimator = {});
     ~MCTS();
 
     /**
@@ -19,7 +117,37 @@ public:
     void run();
 
     /**
-     * @brief Applies kernelization rules to simplify the problem at the given node.
+     * @brief Attempts one select-expand-simulate-backpropagate iteration.
+     * @return false if the iteration was abandoned because a concurrent worker
+     *         exhausted or filled the selected node first.
+     */
+    bool iterate();
+
+    /**
+     * @brief Grows the shared tree with several worker threads (tree parallelism).
+     *
+     * The calling thread keeps its stream; every other worker draws from a fresh
+     * stream of seed, so workers are decorrelated and each stream is replayable
+     * (the interleaving of workers is not).
+     * @param iterations Total number of iterations shared by all workers.
+     * @param numThreads Number of worker threads; 1 runs the sequential loop.
+     * @param placement Pin the workers (the caller included, for the duration of the call)
+     *        to CPUs of the caller's affinity mask, starting at the caller's CPU, so a
+     *        Compact tree stays within one L3 domain as long as it fits and a caller
+     *        restricted to a slice (e.g. one --jobs worker) keeps its tree in that slice.
+     * @param deadlineSeconds Stop starting iterations after this many seconds (0 = none).
+     */
+    void runParallel(int iterations, int numThreads, Placement placement = Placement::None,
+                     double deadlineSeconds = 0.0);
+
+    /**
+     * @brief Applies kernelization rules to simplify the problem at the given node
+     *        (kernelize() with this tree's answer, kernelPool and kernelStats).
+     *
+     * Nodes are reduced once, against the answer at the time. A frontier node is not
+     * re-reduced in place when the answer improves (other workers may be reading its
+     * state); its children are built with the current answer, so the tighter Rule 3
+     * reaches the frontier lazily, at its next expansion.
      * @param node Pointer to the node to be kernelized.
      * @return true if any reduction was applied, false otherwise.
      */
@@ -40,15 +168,189 @@ public:
      */
     Graph graph;
 
+    /**
+     * @brief Seed of this tree's random streams (stream 0: constructing thread,
+     *        later streams: runParallel workers).
+     */
+    std::uint64_t seed;
+
+    /**
+     * @brief Next unused stream index of seed.
+     */
+    std::atomic<std::uint64_t> nextStream{1};
+
     /**
      * @brief Exploration parameter for UCT sampling.
      */
     double explorationParam = 0.0;
 
+    /**
+     * @brief Child selection rule (epsilon-greedy by default).
+     */
+    SelectionPolicy selectionPolicy = SelectionPolicy::EpsilonGreedy;
+
+    /**
+     * @brief Rollout rule of simulate() (deterministic greedy by default).
+     */
+    RolloutPolicy rolloutPolicy = RolloutPolicy::Greedy;
+
+    /**
+     * @brief Prior estimator of this tree; empty uses the global treePolicy::estimatePolicy.
+     */
+    treePolicy::EstimatePolicy estimatePolicy;
+
+    /**
+     * @brief Sets this tree's prior estimator and re-estimates the root.
+     */
+    void setEstimatePolicy(treePolicy::EstimatePolicy policy);
+
+    /**
+     * @brief Batch prior estimator of this tree (takes precedence over estimatePolicy);
+     *        when neither is set the global batch, then per-vertex, estimator applies.
+     */
+    treePolicy::BatchEstimatePolicy batchEstimatePolicy;
+
+    /**
+     * @brief Sets this tree's batch estimator and re-selects the root action from fresh priors.
+     */
+    void setBatchEstimatePolicy(treePolicy::BatchEstimatePolicy policy);
+
+    /**
+     * @brief Pool used by the parallel Hopcroft-Karp in Rule 4 (nullptr when sequential).
+     */
+    std::unique_ptr<WorkStealingPool> kernelPool;
+
+    /**
+     * @brief Reduction counters of this tree's kernelization.
+     */
+    KernelStats kernelStats;
+
+    /**
+     * @brief Nodes in the tree (root included), counted as children are published.
+     */
+    std::atomic<long long> nodeCount{1};
+
+    /**
+     * @brief Completed iterations (abandoned attempts are not counted).
+     */
+    std::atomic<long long> iterationCount{0};
+
     /**
      * @brief The best answer found so far (size of minimum vertex cover).
      */
-    int answer;
+    std::atomic<int> answer;
+
+    /**
+     * @brief Lowers the best answer if the given cover size improves it.
+     * @param coverSize Size of a complete vertex cover.
+     * @return true if the answer was improved.
+     */
+    bool updateAnswer(int coverSize);
+
+    /**
+     * @brief Selection flags of the best cover found so far (size == answer once found).
+     */
+    std::vector<bool> bestCover;
+
+    /**
+     * @brief Guards bestCover and bestCoverSize.
+     */
+    std::mutex incumbentMutex;
+
+    /**
+     * @brief Size of bestCover (numVertices + 1 while empty).
+     */
+    int bestCoverSize;
+
+    /**
+     * @brief Optional incumbent shared with other solvers of the same instance (not owned).
+     */
+    SharedIncumbent* sharedIncumbent = nullptr;
+
+    /**
+     * @brief Records a complete cover as incumbent if it improves the answer, and publishes it.
+     * @param cover Selection flags of a complete vertex cover.
+     * @return true if the answer was improved.
+     */
+    bool updateIncumbent(const std::vector<bool>& cover);
+
+    /**
+     * @brief Attaches a shared incumbent: publishes the current cover and pulls a better one.
+     * @param incumbent Shared incumbent, or nullptr to detach.
+     */
+    void setSharedIncumbent(SharedIncumbent* incumbent);
+
+    /**
+     * @brief Pulls the shared incumbent into answer/bestCover if it is better.
+     * @return true if the answer was improved.
+     */
+    bool syncIncumbent();
+
+    /**
+     * @brief Close nodes whose lowerBound reached the answer (branch and bound).
+     */
+    bool pruning = true;
+
+    /**
+     * @brief Closes a node that cannot lead to a cover smaller than the answer.
+     *
+     * The node becomes terminal (expandable 0, propagated with expandableUpdate) once
+     * its bound reaches the answer. Checked when a child is built and again lazily in
+     * select(), since the answer keeps dropping after a node is built.
+     * @return true if the node is dominated (whether or not this call closed it).
+     */
+    bool prune(Node* node);
+
+    /**
+     * @brief Raises the bounds of a node and its ancestors from their children's bounds.
+     *
+     * A full node's subtree holds no cover below the smaller of its children's bounds.
+     * Propagation stops at the first node that does not rise. Raises use sequentially
+     * consistent CAS, so of two workers raising sibling bounds at least one sees both.
+     */
+    void propagateBound(Node* node);
+
+    /**
+     * @brief Global lower bound: the root's bound (equals answer once optimality is proven).
+     */
+    int lowerBound() const { return root->bound; }
+
+    /**
+     * @brief Whether the answer is proven optimal: the root is closed or exhausted, or its
+     *        bound has reached the answer (before a select() closes it, or with pruning off).
+     */
+    bool optimal() const { return root->expandable <= 0 || root->bound >= answer; }
+
+    /**
+     * @brief Number of nodes closed by prune(), indexed by depth.
+     */
+    std::vector<long long> prunedPerDepth() const;
+
+    /**
+     * @brief Every improvement of answer so far (a root cover found by the kernelization,
+     *        rollouts, the shared incumbent), stamped when it was made. Concurrent workers
+     *        may append out of time order.
+     */
+    std::vector<AnswerImprovement> answerHistory() const;
+
+    /**
+     * @brief Per-phase calls, time, allocations, removed vertices and hardware counters
+     *        (stats::enableHardwareCounters) of this tree's search.
+     *
+     * Covers the root kernelization and every iterate() attempt (abandoned ones included),
+     * summed over the threads that ran them; work the kernel and estimator pools do on
+     * their own threads is not broken down. Empty (enabled == false) unless built with
+     * -DMCTS_STATS.
+     */
+    stats::SearchStats stats() const;
+
+    /**
+     * @brief Walks the tree and sums the memory of its nodes, states and prior tables,
+     *        with the graph, the estimator scratch and the process RSS (see MemoryReport).
+     *
+     * Must not run concurrently with workers that grow the tree.
+     */
+    MemoryReport memoryReport() const;
 
     /**
      * @brief Sets the exploration parameter for UCT sampling.
@@ -59,14 +361,17 @@ public:
     /**
      * @brief Selects a node to expand.
      * @param node Pointer to the current node.
-     * @return Pointer to the selected node.
+     * @return Pointer to the selected node, or nullptr if the descent hit a node
+     *         that a concurrent worker exhausted.
      */
     Node* select(Node* node);
 
     /**
      * @brief Expands the given node by adding child nodes.
      * @param node Pointer to the node to be expanded.
-     * @return Pointer to the newly created child node.
+     * @return Pointer to the newly created child node. If another worker published
+     *         the same slot first, its child is returned instead; nullptr if the
+     *         node was filled concurrently.
      */
     Node* expand(Node* node);
 
@@ -86,9 +391,50 @@ public:
 
     /**
      * @brief Updates the expandable count of ancestor nodes.
-     * @param node Pointer to the node whose ancestors are to be updated.
+     *
+     * Each terminal child decrements its parent exactly once (fetch_sub), so only
+     * the worker that drives a parent to zero keeps propagating upward.
+     * @param node Pointer to a node that just became terminal (expandable == 0).
      */
     void expandableUpdate(Node* node);
+
+private:
+    /**
+     * @brief Picks the root action vertex, or records the root cover if nothing is left to branch on.
+     */
+    void initRoot();
+
+    /**
+     * @brief estimatePolicy, or the global one when unset.
+     */
+    const treePolicy::EstimatePolicy& activeEstimatePolicy() const;
+
+    /**
+     * @brief Picks the action vertex of a state with the estimator precedence above.
+     */
+    bool selectAction(State& state) const;
+
+    /**
+     * @brief Raises state.lowerBound to |selected| plus the residual bound (bounds.hpp).
+     */
+    void updateLowerBound(State& state) const;
+
+    /**
+     * @brief Counts one pruned node at the given depth.
+     */
+    void recordPrune(int depth);
+
+    /**
+     * @brief Moves the calling thread's stats counters into statsTotals (no-op without MCTS_STATS).
+     */
+    void flushStats();
+
+    mutable std::mutex pruneMutex;
+    std::vector<long long> prunes;  // prunedPerDepth()
+    mutable std::mutex historyMutex;
+    std::vector<AnswerImprovement> history;  // answerHistory()
+    mutable std::mutex statsMutex;
+    stats::SearchStats statsTotals;  // stats()
 };
 
 #endif // MCTS_HPP
\ No newline at end of file
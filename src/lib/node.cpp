@@ -1,5 +1,28 @@
 #include "node.hpp"
 
+ChildSlots::ChildSlots() {
+    for (auto& slot : slots) slot.store(nullptr, std::memory_order_relaxed);
+}
+
+std::size_t ChildSlots::size() const {
+    std::size_t count = 0;
+    while (count < kCapacity && slots[count].load(std::memory_order_acquire) != nullptr) ++count;
+    return count;
+}
+
+bool ChildSlots::empty() const {
+    return slots[0].load(std::memory_order_acquire) == nullptr;
+}
+
+Node* ChildSlots::operator[](std::size_t slot) const {
+    return slots[slot].load(std::memory_order_acquire);
+}
+
+bool ChildSlots::publish(std::size_t slot, Node* child) {
+    Node* expected = nullptr;
+    return slots[slot].compare_exchange_strong(expected, child, std::memory_order_acq_rel);
+}
+
 Node::Node() : parent(nullptr), visits(0), value(0.0), expandable(2) {}
 
 Node::~Node() {
@@ -9,21 +32,38 @@ Node::~Node() {
 }
 
 void Node::addChild(Node* child) {
-    children.push_back(child);
+    bool published = tryAddChild(children.size(), child);
+    assert(published && "addChild raced with a concurrent expansion");
+    (void)published;
+}
+
+bool Node::tryAddChild(std::size_t slot, Node* child) {
+    assert(slot < ChildSlots::kCapacity && "Binary branching allows two children");
     child->parent = this;
+    return children.publish(slot, child);
 }
 
 void Node::addExperience(double reward) {
-    visits++;
+    const int n = visits.fetch_add(1) + 1;
     // value <- value + (reward - value) / visits
-    value += (reward - value) / static_cast<double>(visits);
-    maxValue = std::max(maxValue, reward);
+    double current = value.load();
+    while (!value.compare_exchange_weak(current, current + (reward - current) / static_cast<double>(n)));
+    double best = maxValue.load();
+    while (reward > best && !maxValue.compare_exchange_weak(best, reward));
+}
+
+bool Node::raiseBound(int lowerBound) {
+    int current = bound.load();
+    while (lowerBound > current) {
+        if (bound.compare_exchange_weak(current, lowerBound)) return true;
+    }
+    return false;
 }
 
 bool Node::full() {
-    return this->children.size() == 2;
+    return this->children.size() == ChildSlots::kCapacity;
 }
 
 double Node::evaluate(const Graph& graph) {
     return 0.0;
-}
\ No newline at end of file
+}
@@ -1,9 +1,75 @@
 #ifndef NODE_HPP
 #define NODE_HPP
 
+#include <array>
+#include <atomic>
+#include <cstddef>
 #include <vector>
 #include "utils.hpp"
 
+class Node;
+
+/**
+ * @brief Fixed-capacity list of child pointers published lock-free.
+ *
+ * Each slot is filled at most once with a CAS from nullptr. Expansion only
+ * targets slot i after slots 0..i-1 are published, so the published children
+ * always form a prefix and size()/iteration stay consistent under concurrency.
+ */
+class ChildSlots {
+public:
+
+    /**
+     * @brief Maximum number of children (binary branching).
+     */
+    static constexpr std::size_t kCapacity = 2;
+
+    ChildSlots();
+
+    /**
+     * @brief Forward iterator over the published children.
+     */
+    class Iterator {
+    public:
+        Iterator(const ChildSlots* slots, std::size_t index) : slots(slots), index(index) {}
+        Node* operator*() const { return (*slots)[index]; }
+        Iterator& operator++() { ++index; return *this; }
+        bool operator!=(const Iterator& other) const { return index != other.index; }
+    private:
+        const ChildSlots* slots;
+        std::size_t index;
+    };
+
+    /**
+     * @brief Number of published children.
+     */
+    std::size_t size() const;
+
+    /**
+     * @brief Checks whether no child has been published yet.
+     */
+    bool empty() const;
+
+    /**
+     * @brief Returns the child in the given slot (nullptr if unpublished).
+     */
+    Node* operator[](std::size_t slot) const;
+
+    /**
+     * @brief Publishes a child into an empty slot.
+     * @param slot Slot index to fill.
+     * @param child Child to publish.
+     * @return true if this call filled the slot, false if another thread won the race.
+     */
+    bool publish(std::size_t slot, Node* child);
+
+    Iterator begin() const { return Iterator(this, 0); }
+    Iterator end() const { return Iterator(this, size()); }
+
+private:
+    std::array<std::atomic<Node*>, kCapacity> slots;
+};
+
 /**
  * @brief Represents a node in the Monte Carlo Tree Search.
  */
@@ -12,19 +78,33 @@ public:
 
     Node();
     ~Node();
-    
+
     /**
      * @brief Constructs a new Node.
      * @param child Pointer to the child node to be added.
      */
     void addChild(Node* child);
 
+    /**
+     * @brief Publishes a child into the given slot with CAS.
+     * @param slot Slot index (0 = include branch, 1 = exclude branch).
+     * @param child Pointer to the child node; its parent is set to this node.
+     * @return true if the child was published, false if the slot was already taken.
+     */
+    bool tryAddChild(std::size_t slot, Node* child);
+
     /**
      * @brief Updates the node's statistics with the given reward.
      * @param reward The reward to be added to the node's experience.
      */
     void addExperience(double reward);
 
+    /**
+     * @brief Raises bound to at least the given value (CAS).
+     * @return true if the bound increased.
+     */
+    bool raiseBound(int lowerBound);
+
     /**
      * @brief Checks if the node is fully expanded.
      * @return true if the node is fully expanded, false otherwise.
@@ -48,29 +128,35 @@ public:
     Node* parent;
 
     /**
-     * @brief Vector of pointers to child nodes.
+     * @brief Child nodes, published lock-free.
      */
-    std::vector<Node*> children;
+    ChildSlots children;
 
     /**
      * @brief Number of times the node has been visited.
      */
-    int visits;
+    std::atomic<int> visits;
 
     /**
      * @brief Average reward of the node.
      */
-    double value;
+    std::atomic<double> value;
 
     /**
      * @brief Maximum reward observed at this node.
      */
-    double maxValue = 0;
+    std::atomic<double> maxValue{0.0};
 
     /**
      * @brief Number of vertices that can be expanded.
      */
-    int expandable = 2;
+    std::atomic<int> expandable{2};
+
+    /**
+     * @brief Lower bound on every cover in this subtree: state.lowerBound when built,
+     *        raised to the smaller bound of the two children once both exist.
+     */
+    std::atomic<int> bound{0};
 };
 
-#endif // NODE_HPP
\ No newline at end of file
+#endif // NODE_HPP
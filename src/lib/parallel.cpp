@@ -0,0 +1,161 @@
+#include "parallel.hpp"
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+
+namespace {
+    // Pool and index of the worker running on this thread (nullptr / -1 elsewhere)
+    thread_local const WorkStealingPool* tl_pool = nullptr;
+    thread_local int tl_index = -1;
+}
+
+WorkStealingPool::WorkStealingPool(int numThreads, Placement placement) {
+    numThreads = std::max(1, numThreads);
+    const std::vector<int> cpus = CpuTopology::host().placement(numThreads, placement);
+    std::vector<std::vector<int>> workerCpus(numThreads);
+    for (int i = 0; i < numThreads && !cpus.empty(); ++i) workerCpus[i] = {cpus[i]};
+    start(workerCpus);
+}
+
+WorkStealingPool::WorkStealingPool(const std::vector<std::vector<int>>& workerCpus) {
+    start(workerCpus.empty() ? std::vector<std::vector<int>>(1) : workerCpus);
+}
+
+void WorkStealingPool::start(const std::vector<std::vector<int>>& workerCpus) {
+    const int numThreads = static_cast<int>(workerCpus.size());
+    queues.reserve(numThreads);
+    for (int i = 0; i < numThreads; ++i) queues.push_back(std::make_unique<WorkerQueue>());
+    threads.reserve(numThreads);
+    for (int i = 0; i < numThreads; ++i) {
+        threads.emplace_back(&WorkStealingPool::workerLoop, this, i, workerCpus[i]);
+    }
+}
+
+WorkStealingPool::~WorkStealingPool() {
+    wait();
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (std::thread& th : threads) th.join();
+}
+
+int WorkStealingPool::size() const {
+    return static_cast<int>(threads.size());
+}
+
+int WorkStealingPool::workerIndex() const {
+    return tl_pool == this ? tl_index : -1;
+}
+
+void WorkStealingPool::submit(std::function<void()> task) {
+    unfinished++;
+    int self = workerIndex();
+    if (self >= 0) {
+        std::lock_guard<std::mutex> lock(queues[self]->mutex);
+        queues[self]->tasks.push_back(std::move(task));
+    } else {
+        std::lock_guard<std::mutex> lock(injectionMutex);
+        injection.push_back(std::move(task));
+    }
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        queued++;
+    }
+    wake.notify_one();
+}
+
+bool WorkStealingPool::runOne(int self) {
+    std::function<void()> task;
+    bool found = false;
+
+    if (self >= 0) {
+        // Own deque: LIFO keeps recently split work hot in cache
+        std::lock_guard<std::mutex> lock(queues[self]->mutex);
+        if (!queues[self]->tasks.empty()) {
+            task = std::move(queues[self]->tasks.back());
+            queues[self]->tasks.pop_back();
+            found = true;
+        }
+    }
+    if (!found) {
+        std::lock_guard<std::mutex> lock(injectionMutex);
+        if (!injection.empty()) {
+            task = std::move(injection.front());
+            injection.pop_front();
+            found = true;
+        }
+    }
+    if (!found) {
+        // Steal the oldest task of another worker
+        const int n = static_cast<int>(queues.size());
+        const int start = self >= 0 ? self + 1 : 0;
+        for (int k = 0; k < n && !found; ++k) {
+            int victim = (start + k) % n;
+            if (victim == self) continue;
+            std::lock_guard<std::mutex> lock(queues[victim]->mutex);
+            if (!queues[victim]->tasks.empty()) {
+                task = std::move(queues[victim]->tasks.front());
+                queues[victim]->tasks.pop_front();
+                found = true;
+            }
+        }
+    }
+    if (!found) return false;
+
+    queued--;
+    task();
+    if (unfinished.fetch_sub(1) == 1) {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        idle.notify_all();
+    }
+    return true;
+}
+
+void WorkStealingPool::workerLoop(int index, std::vector<int> cpus) {
+    // Pin before the first task so everything the worker allocates is first-touched on its node
+    if (!cpus.empty()) CpuTopology::setCurrentAffinity(cpus);
+    tl_pool = this;
+    tl_index = index;
+    while (true) {
+        if (runOne(index)) continue;
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        wake.wait(lock, [&]() { return stopping || queued > 0; });
+        if (stopping && queued == 0) return;
+    }
+}
+
+void WorkStealingPool::wait() {
+    const int self = workerIndex();
+    while (unfinished > 0) {
+        if (runOne(self)) continue;
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        idle.wait_for(lock, std::chrono::milliseconds(1), [&]() { return unfinished == 0 || queued > 0; });
+    }
+}
+
+void WorkStealingPool::parallelFor(int begin, int end, int grain, const std::function<void(int, int)>& body) {
+    if (begin >= end) return;
+    grain = std::max(1, grain);
+    if (end - begin <= grain) {
+        body(begin, end);
+        return;
+    }
+
+    std::atomic<int> remaining(0);
+    for (int lo = begin + grain; lo < end; lo += grain) {
+        int hi = std::min(end, lo + grain);
+        remaining++;
+        submit([&body, &remaining, lo, hi]() {
+            body(lo, hi);
+            remaining--;
+        });
+    }
+    // The caller takes the first chunk, then helps until its chunks are done.
+    body(begin, std::min(end, begin + grain));
+    const int self = workerIndex();
+    while (remaining > 0) {
+        if (!runOne(self)) std::this_thread::yield();
+    }
+}
@@ -0,0 +1,108 @@
+#ifndef PARALLEL_HPP
+#define PARALLEL_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "topology.hpp"
+
+/**
+ * @brief Fixed-size thread pool with per-worker deques and work stealing.
+ *
+ * Tasks submitted from outside the pool go to a FIFO injection queue, so the
+ * submission order is the global start order (submit largest-first for LPT-style
+ * scheduling). Tasks submitted by a worker go to its own deque; the owner pops
+ * LIFO and idle workers steal FIFO from other workers' deques.
+ */
+class WorkStealingPool {
+public:
+
+    /**
+     * @brief Starts the worker threads.
+     * @param numThreads Number of workers (at least 1).
+     * @param placement Pin worker i to CpuTopology::placement(numThreads, placement)[i]
+     *        (None leaves scheduling to the OS).
+     */
+    explicit WorkStealingPool(int numThreads, Placement placement = Placement::None);
+
+    /**
+     * @brief Starts one worker per CPU set, each restricted to its set (an empty set is
+     *        left to the OS), e.g. the slices of CpuTopology::partition().
+     */
+    explicit WorkStealingPool(const std::vector<std::vector<int>>& workerCpus);
+
+    /**
+     * @brief Finishes all queued tasks and joins the workers.
+     */
+    ~WorkStealingPool();
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    /**
+     * @brief Number of worker threads.
+     */
+    int size() const;
+
+    /**
+     * @brief Enqueues a task.
+     * @param task Callable to run on some worker.
+     */
+    void submit(std::function<void()> task);
+
+    /**
+     * @brief Blocks until every submitted task has finished. The caller runs tasks while waiting.
+     */
+    void wait();
+
+    /**
+     * @brief Runs body(lo, hi) over [begin, end) split into chunks of at most grain indices.
+     *
+     * The calling thread executes chunks too, so this is safe to call from inside a task.
+     * @param begin First index.
+     * @param end One past the last index.
+     * @param grain Maximum chunk length (at least 1).
+     * @param body Callable invoked with a half-open chunk [lo, hi).
+     */
+    void parallelFor(int begin, int end, int grain, const std::function<void(int, int)>& body);
+
+    /**
+     * @brief Index of the calling worker in this pool, or -1 for outside threads.
+     */
+    int workerIndex() const;
+
+private:
+    struct WorkerQueue {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    void start(const std::vector<std::vector<int>>& workerCpus);
+    void workerLoop(int index, std::vector<int> cpus);
+
+    /**
+     * @brief Pops and runs one task (own deque, then injection queue, then steal).
+     * @return true if a task was run.
+     */
+    bool runOne(int self);
+
+    std::vector<std::unique_ptr<WorkerQueue>> queues;
+    std::deque<std::function<void()>> injection;
+    std::mutex injectionMutex;
+    std::vector<std::thread> threads;
+
+    std::atomic<int> queued{0};
+    std::atomic<int> unfinished{0};
+    std::atomic<bool> stopping{false};
+
+    std::mutex sleepMutex;
+    std::condition_variable wake;
+    std::condition_variable idle;
+};
+
+#endif // PARALLEL_HPP
@@ -0,0 +1,102 @@
+#include "portfolio.hpp"
+#include "incumbent.hpp"
+#include "parallel.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+Portfolio::Portfolio(Graph& graph, std::vector<PortfolioMember> members, PortfolioOptions options)
+    : graph(graph), configs(std::move(members)), options(options) {}
+
+Portfolio::~Portfolio() = default;
+
+PortfolioResult Portfolio::run() {
+    using Clock = std::chrono::steady_clock;
+    const auto tStart = Clock::now();
+    const int numMembers = static_cast<int>(configs.size());
+    PortfolioResult result;
+    result.iterations.assign(numMembers, 0);
+    result.answers.assign(numMembers, graph.numVertices);
+
+    SharedIncumbent* incumbent = options.incumbent;
+    if (!incumbent) {
+        localIncumbent = SharedIncumbent::local(graph.numVertices);
+        incumbent = localIncumbent.get();
+    }
+
+    // Kernelize once; every member starts from a copy of the reduced root. Only the
+    // reductions run here: each member picks its root action with its own estimator
+    std::unique_ptr<State> sharedRoot;
+    if (options.shareRoot) {
+        std::unique_ptr<WorkStealingPool> pool;
+        if (options.kernelThreads > 1) pool = std::make_unique<WorkStealingPool>(options.kernelThreads);
+        sharedRoot = std::make_unique<State>(graph.numVertices);
+        while (kernelize(graph, *sharedRoot, graph.numVertices, pool.get()));
+        result.rootKernelSeconds = std::chrono::duration<double>(Clock::now() - tStart).count();
+    }
+
+    // Within the caller's affinity mask, like MCTS::runParallel
+    const std::vector<int> cpus = options.placement == Placement::None
+        ? std::vector<int>()
+        : CpuTopology::host().placement(numMembers, options.placement, -1, CpuTopology::currentAffinity());
+    const bool hasDeadline = options.deadlineSeconds > 0.0;
+    const auto deadline = tStart + std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<double>(options.deadlineSeconds));
+    std::atomic<bool> stop(false);
+    std::atomic<int> prover(-1);
+    trees.clear();
+    trees.resize(numMembers);
+
+    auto member = [&](int i) {
+        if (!cpus.empty()) CpuTopology::pinCurrentThread(cpus[i]);
+        const PortfolioMember& config = configs[i];
+        // Built on the member's own thread: its stream is seeded here and its tree is first-touched here
+        std::unique_ptr<MCTS> mcts = sharedRoot
+            ? std::make_unique<MCTS>(graph, *sharedRoot, config.explorationParam, 1, options.seed + i, config.estimator)
+            : std::make_unique<MCTS>(graph, config.explorationParam, options.kernelThreads, options.seed + i,
+                                     config.estimator);
+        mcts->selectionPolicy = config.selection;
+        mcts->rolloutPolicy = config.rollout;
+        mcts->setSharedIncumbent(incumbent);
+
+        long long done = 0;
+        while (!stop.load(std::memory_order_relaxed)) {
+            if (mcts->optimal()) {
+                // Tree exhausted or closed by its bound: its answer (synced with every member's) is optimal
+                int expected = -1;
+                prover.compare_exchange_strong(expected, i);
+                stop = true;
+                break;
+            }
+            if (hasDeadline && Clock::now() >= deadline) {
+                stop = true;
+                break;
+            }
+            if (options.maxIterations > 0 && done >= options.maxIterations) break;
+            mcts->iterate();
+            ++done;
+        }
+        mcts->syncIncumbent();
+        result.iterations[i] = done;
+        result.answers[i] = mcts->answer;
+        trees[i] = std::move(mcts);
+    };
+
+    std::vector<std::thread> threads;
+    threads.reserve(numMembers);
+    for (int i = 0; i < numMembers; ++i) threads.emplace_back(member, i);
+    for (std::thread& th : threads) th.join();
+
+    result.prover = prover;
+    result.optimal = result.prover >= 0;
+    int size = incumbent->fetch(graph.numVertices + 2, result.cover);
+    if (size >= 0) {
+        result.answer = size;
+    } else {
+        result.answer = numMembers > 0 ? *std::min_element(result.answers.begin(), result.answers.end())
+                                       : graph.numVertices;
+    }
+    result.seconds = std::chrono::duration<double>(Clock::now() - tStart).count();
+    return result;
+}
@@ -0,0 +1,86 @@
+#ifndef PORTFOLIO_HPP
+#define PORTFOLIO_HPP
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "mcts.hpp"
+#include "topology.hpp"
+#include "utils.hpp"
+
+class SharedIncumbent;
+
+/**
+ * @brief One search configuration of a portfolio.
+ */
+struct PortfolioMember {
+    std::string name;
+    SelectionPolicy selection = SelectionPolicy::EpsilonGreedy;
+    double explorationParam = 0.0;
+    RolloutPolicy rollout = RolloutPolicy::Greedy;
+    treePolicy::EstimatePolicy estimator;   // empty: global treePolicy::estimatePolicy
+};
+
+/**
+ * @brief Settings shared by all members of a portfolio run.
+ */
+struct PortfolioOptions {
+    double deadlineSeconds = 0.0;       // wall-clock budget (0 = none)
+    long long maxIterations = 0;        // per-member iteration cap (0 = none)
+    bool shareRoot = true;              // kernelize the root once and hand each member a copy
+    int kernelThreads = 1;              // Rule 4 threads for the root kernelization
+    std::uint64_t seed = rng::kDefaultSeed; // member i searches with seed + i
+    Placement placement = Placement::None;
+    SharedIncumbent* incumbent = nullptr; // external incumbent (e.g. cross-process); a local one otherwise
+};
+
+/**
+ * @brief Outcome of a portfolio run.
+ */
+struct PortfolioResult {
+    int answer = 0;                     // best cover size over all members
+    std::vector<bool> cover;            // that cover
+    bool optimal = false;               // a member exhausted its tree
+    int prover = -1;                    // index of that member (-1 if none)
+    double seconds = 0.0;               // wall time of the search (root kernelization included)
+    double rootKernelSeconds = 0.0;     // shared root kernelization (0 when not shared)
+    std::vector<long long> iterations;  // iterations per member
+    std::vector<int> answers;           // each member's own answer at the end
+};
+
+/**
+ * @brief Runs several MCTS configurations on one instance, one thread each.
+ *
+ * Members exchange incumbents through a SharedIncumbent (synced at every iteration,
+ * so Rule 3 in every tree tightens with the best cover of any member). All members
+ * stop as soon as one proves optimality (its root becomes non-expandable), the
+ * deadline passes, or every member reached maxIterations.
+ */
+class Portfolio {
+public:
+
+    Portfolio(Graph& graph, std::vector<PortfolioMember> members, PortfolioOptions options = PortfolioOptions());
+    ~Portfolio();
+
+    /**
+     * @brief Runs the members to completion (see class description).
+     */
+    PortfolioResult run();
+
+    /**
+     * @brief Search tree of member i after run() (nullptr before).
+     */
+    const MCTS* tree(std::size_t i) const { return i < trees.size() ? trees[i].get() : nullptr; }
+
+    const std::vector<PortfolioMember>& members() const { return configs; }
+
+private:
+    Graph& graph;
+    std::vector<PortfolioMember> configs;
+    PortfolioOptions options;
+    std::vector<std::unique_ptr<MCTS>> trees;
+    std::unique_ptr<SharedIncumbent> localIncumbent;
+};
+
+#endif // PORTFOLIO_HPP
@@ -0,0 +1,201 @@
+#include "stats.hpp"
+
+namespace stats {
+
+    const char* phaseName(int phase) {
+        static const char* const kNames[kNumPhases] = {
+            "select", "expand", "kernelize", "rule1", "rule2", "rule3", "rule4", "matching", "bound", "estimator",
+            "rollout", "backpropagate"
+        };
+        return phase >= 0 && phase < kNumPhases ? kNames[phase] : "?";
+    }
+
+    bool countedPhase(int phase) {
+        return phase == Select || phase == Kernelize || phase == Estimator || phase == Rollout;
+    }
+
+    const char* counterName(int counter) {
+        static const char* const kNames[kNumCounters] = {
+            "cycles", "instructions", "l1d_misses", "llc_misses", "branch_misses"
+        };
+        return counter >= 0 && counter < kNumCounters ? kNames[counter] : "?";
+    }
+
+    void SearchStats::merge(const SearchStats& other) {
+        enabled = enabled || other.enabled;
+        iterations += other.iterations;
+        counterMask |= other.counterMask;
+        for (int p = 0; p < kNumPhases; ++p) {
+            phases[p].calls += other.phases[p].calls;
+            phases[p].nanos += other.phases[p].nanos;
+            phases[p].allocations += other.phases[p].allocations;
+            phases[p].removed += other.phases[p].removed;
+            for (int c = 0; c < kNumCounters; ++c) phases[p].counters[c] += other.phases[p].counters[c];
+        }
+    }
+}
+
+#ifdef MCTS_STATS
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace {
+    thread_local long long threadAllocations = 0;
+
+    std::atomic<bool> countersOn{false};
+
+    long long nowNanos() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    // The calling thread's perf_event_open group: one leader, the other events attached,
+    // all read at once. Opened on first use, closed with the thread.
+    class PerfGroup {
+    public:
+        PerfGroup() {
+            slot.fill(-1);
+#if defined(__linux__)
+            const std::uint64_t l1dReadMiss = PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8)
+                                              | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+            const struct { std::uint32_t type; std::uint64_t config; } events[stats::kNumCounters] = {
+                {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+                {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+                {PERF_TYPE_HW_CACHE, l1dReadMiss},
+                {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+                {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+            };
+            for (int c = 0; c < stats::kNumCounters; ++c) {
+                perf_event_attr attr;
+                std::memset(&attr, 0, sizeof(attr));
+                attr.size = sizeof(attr);
+                attr.type = events[c].type;
+                attr.config = events[c].config;
+                attr.exclude_kernel = 1;
+                attr.exclude_hv = 1;
+                attr.read_format = PERF_FORMAT_GROUP;
+                attr.disabled = leader < 0 ? 1 : 0;
+                // This thread, any CPU; an event the machine lacks is just left out
+                const int fd = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, leader, 0));
+                if (fd < 0) continue;
+                if (leader < 0) leader = fd;
+                fds[size] = fd;
+                slot[c] = size++;
+                mask |= 1u << c;
+            }
+            if (leader >= 0) ioctl(leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+#endif
+        }
+
+        ~PerfGroup() {
+#if defined(__linux__)
+            for (int i = 0; i < size; ++i) close(fds[i]);
+#endif
+        }
+
+        // Current counts; false if the group could not be read
+        bool read(std::array<long long, stats::kNumCounters>& values) const {
+            if (leader < 0) return false;
+#if defined(__linux__)
+            std::uint64_t buffer[1 + stats::kNumCounters];
+            const ssize_t bytes = ::read(leader, buffer, sizeof(buffer));
+            if (bytes < static_cast<ssize_t>(sizeof(std::uint64_t) * (1 + size))) return false;
+            for (int c = 0; c < stats::kNumCounters; ++c) {
+                values[c] = slot[c] >= 0 ? static_cast<long long>(buffer[1 + slot[c]]) : 0;
+            }
+            return true;
+#else
+            return false;
+#endif
+        }
+
+        unsigned mask = 0;  // bit c: Counter c is in the group
+
+    private:
+        int leader = -1;
+        int size = 0;
+        std::array<int, stats::kNumCounters> fds{};
+        std::array<int, stats::kNumCounters> slot;  // position of each counter in a group read
+    };
+
+    PerfGroup& perfGroup() {
+        thread_local PerfGroup group;
+        return group;
+    }
+}
+
+namespace stats {
+
+    SearchStats& local() {
+        thread_local SearchStats counters;
+        counters.enabled = true;
+        return counters;
+    }
+
+    SearchStats take() {
+        SearchStats& counters = local();
+        SearchStats taken = counters;
+        counters = SearchStats();
+        return taken;
+    }
+
+    long long allocations() {
+        return threadAllocations;
+    }
+
+    unsigned enableHardwareCounters(bool on) {
+        countersOn.store(on, std::memory_order_relaxed);
+        return on ? perfGroup().mask : 0;
+    }
+
+    Scope::Scope(Phase phase) : phase(phase) {
+        // Counters are read first and the clock last, so neither read is timed
+        if (countedPhase(phase) && countersOn.load(std::memory_order_relaxed)) {
+            counting = perfGroup().read(startCounters);
+        }
+        startAllocations = threadAllocations;
+        startNanos = nowNanos();
+    }
+
+    Scope::~Scope() {
+        const long long endNanos = nowNanos();
+        SearchStats& counters = local();
+        PhaseTotals& totals = counters.phases[phase];
+        ++totals.calls;
+        totals.nanos += endNanos - startNanos;
+        totals.allocations += threadAllocations - startAllocations;
+        std::array<long long, kNumCounters> end;
+        if (counting && perfGroup().read(end)) {
+            for (int c = 0; c < kNumCounters; ++c) totals.counters[c] += end[c] - startCounters[c];
+            counters.counterMask |= perfGroup().mask;
+        }
+    }
+}
+
+// Counting replacements of the global allocation functions; weak, so a program that
+// replaces them itself (e.g. test_estimator) keeps its own (allocations then read 0)
+__attribute__((weak)) void* operator new(std::size_t size) {
+    ++threadAllocations;
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+__attribute__((weak)) void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+__attribute__((weak)) void operator delete(void* p, std::size_t) noexcept {
+    std::free(p);
+}
+#endif
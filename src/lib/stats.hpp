@@ -0,0 +1,127 @@
+#ifndef STATS_HPP
+#define STATS_HPP
+
+#include <array>
+
+/**
+ * @brief Per-phase instrumentation of the search, compiled in with -DMCTS_STATS.
+ *
+ * Each thread accumulates into its own counters (no atomics, no locks); MCTS merges them
+ * into the tree's totals after every iteration. Without MCTS_STATS the scope and count
+ * macros expand to nothing and SearchStats stays empty (enabled == false).
+ *
+ * On Linux the coarse phases (Select, Kernelize, Estimator, Rollout) can also read
+ * hardware counters through perf_event_open (enableHardwareCounters()); where the
+ * kernel or the machine has none, only wall time is recorded.
+ */
+namespace stats {
+
+    /**
+     * @brief Instrumented phases. Times are inclusive: Expand contains Kernelize, Bound and
+     *        Estimator of the new child; Kernelize (a whole fixpoint) contains the rules, and
+     *        Rule4 contains Matching.
+     */
+    enum Phase : int {
+        Select, Expand, Kernelize, Rule1, Rule2, Rule3, Rule4, Matching, Bound, Estimator, Rollout,
+        Backpropagate, kNumPhases
+    };
+
+    /**
+     * @brief Lower-case name of a phase (CSV label).
+     */
+    const char* phaseName(int phase);
+
+    /**
+     * @brief Whether a phase reads the hardware counters (Select, Kernelize, Estimator, Rollout).
+     */
+    bool countedPhase(int phase);
+
+    /**
+     * @brief Hardware events read around the counted phases (user space only).
+     */
+    enum Counter : int {
+        Cycles, Instructions, L1dMisses, LlcMisses, BranchMisses,
+        kNumCounters
+    };
+
+    /**
+     * @brief Lower-case name of a counter (CSV label).
+     */
+    const char* counterName(int counter);
+
+    struct PhaseTotals {
+        long long calls = 0;
+        long long nanos = 0;
+        long long allocations = 0;  // operator new calls inside the phase (nested phases included)
+        long long removed = 0;      // vertices taken out of the residual (kernelization rules only)
+        std::array<long long, kNumCounters> counters{}; // hardware events (see SearchStats::counterMask)
+    };
+
+    struct SearchStats {
+        bool enabled = false;       // built with MCTS_STATS
+        long long iterations = 0;   // completed iterations the phases add up over
+        unsigned counterMask = 0;   // bit c set: Counter c was read (else its totals stay 0)
+        std::array<PhaseTotals, kNumPhases> phases{};
+
+        bool hasCounter(int counter) const { return (counterMask >> counter) & 1u; }
+        void merge(const SearchStats& other);
+    };
+
+#ifdef MCTS_STATS
+    /**
+     * @brief The calling thread's counters since its last take().
+     */
+    SearchStats& local();
+
+    /**
+     * @brief Returns and clears the calling thread's counters.
+     */
+    SearchStats take();
+
+    /**
+     * @brief operator new calls made by the calling thread so far.
+     */
+    long long allocations();
+
+    /**
+     * @brief Turns hardware counting of the counted phases on or off (off by default).
+     *
+     * Each thread opens its own perf_event_open group on first use; events the machine
+     * lacks are left out. Reading costs a system call per phase boundary.
+     * @return Mask of the events the calling thread can read (0: none, wall time only).
+     */
+    unsigned enableHardwareCounters(bool on);
+
+    /**
+     * @brief Times one phase from construction to destruction (steady_clock).
+     */
+    class Scope {
+    public:
+        explicit Scope(Phase phase);
+        ~Scope();
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        Phase phase;
+        long long startNanos;
+        long long startAllocations;
+        bool counting = false;
+        std::array<long long, kNumCounters> startCounters;
+    };
+#endif
+}
+
+#ifdef MCTS_STATS
+#define MCTS_STATS_CONCAT_(a, b) a##b
+#define MCTS_STATS_CONCAT(a, b) MCTS_STATS_CONCAT_(a, b)
+#define MCTS_STATS_SCOPE(phase) ::stats::Scope MCTS_STATS_CONCAT(statsScope_, __LINE__)(::stats::phase)
+#define MCTS_STATS_REMOVED(phase, count) (::stats::local().phases[::stats::phase].removed += (count))
+#define MCTS_STATS_RESET() ((void)::stats::take())
+#else
+#define MCTS_STATS_SCOPE(phase) ((void)0)
+#define MCTS_STATS_REMOVED(phase, count) ((void)0)
+#define MCTS_STATS_RESET() ((void)0)
+#endif
+
+#endif // STATS_HPP
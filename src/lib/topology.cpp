@@ -0,0 +1,209 @@
+#include "topology.hpp"
+#include <algorithm>
+#include <dirent.h>
+#include <fstream>
+#include <map>
+#include <sched.h>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <pthread.h>
+
+namespace {
+    const std::string kCpuRoot = "/sys/devices/system/cpu/";
+
+    bool readInt(const std::string& path, int& value) {
+        std::ifstream in(path);
+        return static_cast<bool>(in >> value);
+    }
+
+    std::string readLine(const std::string& path) {
+        std::ifstream in(path);
+        std::string line;
+        std::getline(in, line);
+        return line;
+    }
+
+    // Parses a sysfs CPU list such as "0-3,8-11".
+    std::vector<int> parseCpuList(const std::string& list) {
+        std::vector<int> cpuIds;
+        std::stringstream ss(list);
+        std::string range;
+        while (std::getline(ss, range, ',')) {
+            if (range.empty()) continue;
+            std::size_t dash = range.find('-');
+            try {
+                int lo = std::stoi(range.substr(0, dash));
+                int hi = dash == std::string::npos ? lo : std::stoi(range.substr(dash + 1));
+                for (int c = lo; c <= hi; ++c) cpuIds.push_back(c);
+            } catch (...) {
+                return {};
+            }
+        }
+        return cpuIds;
+    }
+
+    // Lowest CPU sharing the L3 of cpu, or -1 if sysfs reports no L3.
+    int l3Domain(int cpu) {
+        const std::string cacheDir = kCpuRoot + "cpu" + std::to_string(cpu) + "/cache/";
+        for (int index = 0; ; ++index) {
+            const std::string dir = cacheDir + "index" + std::to_string(index) + "/";
+            int level = 0;
+            if (!readInt(dir + "level", level)) return -1;
+            if (level != 3) continue;
+            std::vector<int> shared = parseCpuList(readLine(dir + "shared_cpu_list"));
+            return shared.empty() ? cpu : *std::min_element(shared.begin(), shared.end());
+        }
+    }
+
+    int numaNode(int cpu) {
+        const std::string dir = kCpuRoot + "cpu" + std::to_string(cpu);
+        DIR* d = opendir(dir.c_str());
+        if (!d) return 0;
+        int node = 0;
+        while (dirent* entry = readdir(d)) {
+            std::string name = entry->d_name;
+            if (name.size() > 4 && name.compare(0, 4, "node") == 0 &&
+                std::all_of(name.begin() + 4, name.end(), ::isdigit)) {
+                node = std::stoi(name.substr(4));
+                break;
+            }
+        }
+        closedir(d);
+        return node;
+    }
+}
+
+CpuTopology::CpuTopology() {
+    std::vector<int> allowed = currentAffinity();
+    std::vector<Cpu> found;
+    for (int id : allowed) {
+        const std::string topo = kCpuRoot + "cpu" + std::to_string(id) + "/topology/";
+        Cpu cpu{id, 0, id, -1, 0};
+        readInt(topo + "physical_package_id", cpu.package);
+        readInt(topo + "core_id", cpu.core);
+        cpu.domain = l3Domain(id);
+        cpu.node = numaNode(id);
+        found.push_back(cpu);
+    }
+    // Without L3 information every package is one domain (keyed by its lowest CPU)
+    std::map<int, int> packageFirst;
+    for (const Cpu& cpu : found) {
+        auto it = packageFirst.find(cpu.package);
+        if (it == packageFirst.end() || cpu.id < it->second) packageFirst[cpu.package] = cpu.id;
+    }
+    for (Cpu& cpu : found) {
+        if (cpu.domain < 0) cpu.domain = packageFirst[cpu.package];
+    }
+
+    // Compact order: by domain, then the k-th SMT thread of every core before the (k+1)-th
+    std::map<std::tuple<int, int, int>, int> siblingRank; // (package, core, id) -> rank among siblings
+    std::map<std::pair<int, int>, int> seen;
+    std::vector<Cpu> byId = found;
+    std::sort(byId.begin(), byId.end(), [](const Cpu& a, const Cpu& b) { return a.id < b.id; });
+    for (const Cpu& cpu : byId) siblingRank[{cpu.package, cpu.core, cpu.id}] = seen[{cpu.package, cpu.core}]++;
+    std::sort(found.begin(), found.end(), [&](const Cpu& a, const Cpu& b) {
+        int ra = siblingRank[{a.package, a.core, a.id}];
+        int rb = siblingRank[{b.package, b.core, b.id}];
+        return std::tie(a.package, a.domain, ra, a.core, a.id) < std::tie(b.package, b.domain, rb, b.core, b.id);
+    });
+
+    ordered = found;
+    for (std::size_t i = 0; i < ordered.size(); ++i) {
+        if (i == 0 || ordered[i].domain != ordered[i - 1].domain) domainStarts.push_back(static_cast<int>(i));
+    }
+}
+
+const CpuTopology& CpuTopology::host() {
+    static const CpuTopology topology;
+    return topology;
+}
+
+std::vector<int> CpuTopology::placement(int numThreads, Placement placement, int anchorCpu,
+                                        const std::vector<int>& within) const {
+    std::vector<int> result;
+    if (placement == Placement::None || ordered.empty() || numThreads <= 0) return result;
+
+    // Only CPUs of `within`, unless it holds no usable CPU
+    auto inWithin = [&within](int id) { return std::find(within.begin(), within.end(), id) != within.end(); };
+    const bool restricted = std::any_of(ordered.begin(), ordered.end(), [&](const Cpu& cpu) { return inWithin(cpu.id); });
+
+    // Domains as lists of CPUs, rotated so the anchor's domain (and the anchor) come first
+    std::vector<std::vector<int>> domains;
+    int anchorDomain = 0;
+    for (int d = 0; d < numDomains(); ++d) {
+        int end = d + 1 < numDomains() ? domainStarts[d + 1] : static_cast<int>(ordered.size());
+        std::vector<int> dom;
+        for (int i = domainStarts[d]; i < end; ++i) {
+            if (restricted && !inWithin(ordered[i].id)) continue;
+            if (ordered[i].id == anchorCpu) anchorDomain = static_cast<int>(domains.size());
+            dom.push_back(ordered[i].id);
+        }
+        if (!dom.empty()) domains.push_back(std::move(dom));
+    }
+    std::rotate(domains.begin(), domains.begin() + anchorDomain, domains.end());
+    auto anchorPos = std::find(domains[0].begin(), domains[0].end(), anchorCpu);
+    if (anchorPos != domains[0].end()) std::rotate(domains[0].begin(), anchorPos, anchorPos + 1);
+
+    std::size_t usable = 0;
+    for (const std::vector<int>& dom : domains) usable += dom.size();
+    std::vector<int> order;
+    order.reserve(usable);
+    if (placement == Placement::Compact) {
+        for (const std::vector<int>& dom : domains) order.insert(order.end(), dom.begin(), dom.end());
+    } else {
+        for (std::size_t k = 0; order.size() < usable; ++k) {
+            for (const std::vector<int>& dom : domains) {
+                if (k < dom.size()) order.push_back(dom[k]);
+            }
+        }
+    }
+
+    result.reserve(numThreads);
+    for (int t = 0; t < numThreads; ++t) result.push_back(order[t % order.size()]);
+    return result;
+}
+
+std::vector<std::vector<int>> CpuTopology::partition(int numSlices) const {
+    std::vector<std::vector<int>> slices(std::max(0, numSlices));
+    if (slices.empty() || ordered.empty()) return slices;
+    const int numCpus = static_cast<int>(ordered.size());
+    if (numSlices >= numCpus) {
+        for (int s = 0; s < numSlices; ++s) slices[s].push_back(ordered[s % numCpus].id);
+        return slices;
+    }
+    for (int s = 0, next = 0; s < numSlices; ++s) {
+        const int size = numCpus / numSlices + (s < numCpus % numSlices ? 1 : 0);
+        for (int i = 0; i < size; ++i) slices[s].push_back(ordered[next++].id);
+    }
+    return slices;
+}
+
+bool CpuTopology::pinCurrentThread(int cpu) {
+    return setCurrentAffinity({cpu});
+}
+
+std::vector<int> CpuTopology::currentAffinity() {
+    std::vector<int> cpuIds;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (pthread_getaffinity_np(pthread_self(), sizeof(set), &set) != 0) return cpuIds;
+    for (int c = 0; c < CPU_SETSIZE; ++c) {
+        if (CPU_ISSET(c, &set)) cpuIds.push_back(c);
+    }
+    return cpuIds;
+}
+
+bool CpuTopology::setCurrentAffinity(const std::vector<int>& cpuIds) {
+    if (cpuIds.empty()) return false;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int c : cpuIds) {
+        if (c >= 0 && c < CPU_SETSIZE) CPU_SET(c, &set);
+    }
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+}
+
+int CpuTopology::currentCpu() {
+    return sched_getcpu();
+}
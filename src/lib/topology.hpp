@@ -0,0 +1,96 @@
+#ifndef TOPOLOGY_HPP
+#define TOPOLOGY_HPP
+
+#include <vector>
+
+/**
+ * @brief How worker threads are pinned to CPUs.
+ *
+ * Compact fills one L3 domain (distinct physical cores first, then SMT siblings)
+ * before moving to the next, so workers of one tree or component share a cache.
+ * Scatter deals workers round-robin over L3 domains, for independent jobs.
+ */
+enum class Placement { None, Compact, Scatter };
+
+/**
+ * @brief CPU layout of the host as read from /sys/devices/system/cpu.
+ *
+ * Only CPUs in the calling thread's affinity mask at the first host() call are listed,
+ * so programs call host() from main before pinning any thread (a first call from a
+ * pinned thread would see that thread's CPUs only). Pinned workers allocate their nodes,
+ * States and scratch buffers themselves, so with the kernel's first-touch policy that
+ * memory lands on the worker's own NUMA node.
+ */
+class CpuTopology {
+public:
+
+    struct Cpu {
+        int id;         // logical CPU number
+        int package;    // physical_package_id (socket)
+        int core;       // core_id within the package
+        int domain;     // lowest CPU sharing this CPU's L3 (the package when no L3 is reported)
+        int node;       // NUMA node (0 when unknown)
+    };
+
+    /**
+     * @brief Topology of this host, parsed once.
+     */
+    static const CpuTopology& host();
+
+    /**
+     * @brief Usable CPUs in compact order (see Placement::Compact).
+     */
+    const std::vector<Cpu>& cpus() const { return ordered; }
+
+    /**
+     * @brief Number of distinct L3 domains.
+     */
+    int numDomains() const { return static_cast<int>(domainStarts.size()); }
+
+    /**
+     * @brief CPU for each of numThreads workers (wrapping when there are more workers than CPUs).
+     * @param numThreads Number of workers.
+     * @param placement Compact or Scatter; None yields an empty list.
+     * @param anchorCpu Start in this CPU's domain, with this CPU first (-1: first domain).
+     * @param within Only place on these CPUs (e.g. the caller's slice from partition());
+     *        empty, or no usable CPU in it, means all usable CPUs.
+     */
+    std::vector<int> placement(int numThreads, Placement placement, int anchorCpu = -1,
+                               const std::vector<int>& within = {}) const;
+
+    /**
+     * @brief Splits the usable CPUs into numSlices disjoint slices of consecutive CPUs in
+     *        compact order (sizes differ by at most one), so a slice stays within an L3
+     *        domain where it fits. With more slices than CPUs, slices wrap and share CPUs.
+     */
+    std::vector<std::vector<int>> partition(int numSlices) const;
+
+    /**
+     * @brief Restricts the calling thread to one CPU.
+     * @return false if the kernel refused (the thread keeps its previous mask).
+     */
+    static bool pinCurrentThread(int cpu);
+
+    /**
+     * @brief Affinity mask of the calling thread.
+     */
+    static std::vector<int> currentAffinity();
+
+    /**
+     * @brief Restores an affinity mask returned by currentAffinity().
+     */
+    static bool setCurrentAffinity(const std::vector<int>& cpuIds);
+
+    /**
+     * @brief CPU the calling thread is running on (-1 if unknown).
+     */
+    static int currentCpu();
+
+private:
+    CpuTopology();
+
+    std::vector<Cpu> ordered;       // grouped by domain, each domain in compact order
+    std::vector<int> domainStarts;  // offset of each domain in ordered
+};
+
+#endif // TOPOLOGY_HPP
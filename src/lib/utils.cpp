@@ -1,8 +1,7 @@
 #include "utils.hpp"
 #include "node.hpp"
 #include <cassert>
-#include <random>
-#include <ctime>
+#include <atomic>
 #include <functional>
 #include <cmath>
 #include <fstream>
@@ -10,9 +9,75 @@
 #include <regex>
 
 namespace {
+    std::uint64_t splitmix64(std::uint64_t& x) {
+        std::uint64_t z = (x += 0x9e3779b97f4a7c15ULL);
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+        return z ^ (z >> 31);
+    }
+
+    inline std::uint64_t rotl(std::uint64_t x, int k) {
+        return (x << k) | (x >> (64 - k));
+    }
+
+    // Unseeded threads still get distinct streams of the default seed
+    std::atomic<std::uint64_t> nextDefaultStream(0);
+
     // Thread-local RNG to avoid multiple definition and be safe in multithreaded contexts
-    thread_local std::mt19937 tl_engine(static_cast<unsigned int>(std::time(nullptr)));
-    thread_local std::uniform_real_distribution<double> tl_uniform01(0.0, 1.0);
+    thread_local Xoshiro256 tl_engine(rng::kDefaultSeed, nextDefaultStream.fetch_add(1));
+}
+
+Xoshiro256::Xoshiro256(std::uint64_t seed, std::uint64_t stream) {
+    std::uint64_t x = seed;
+    for (std::uint64_t& word : s) word = splitmix64(x);
+    for (std::uint64_t i = 0; i < stream; ++i) jump();
+}
+
+Xoshiro256::result_type Xoshiro256::operator()() {
+    const std::uint64_t result = rotl(s[1] * 5, 7) * 9;
+    const std::uint64_t t = s[1] << 17;
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = rotl(s[3], 45);
+    return result;
+}
+
+void Xoshiro256::jump() {
+    static const std::uint64_t kJump[] = {
+        0x180ec6d33cfd0abaULL, 0xd5a61266f0c9392cULL, 0xa9582618e03fc9aaULL, 0x39abdc4529b1661cULL
+    };
+    std::uint64_t acc[4] = {0, 0, 0, 0};
+    for (std::uint64_t word : kJump) {
+        for (int b = 0; b < 64; ++b) {
+            if (word & (1ULL << b)) {
+                for (int k = 0; k < 4; ++k) acc[k] ^= s[k];
+            }
+            (*this)();
+        }
+    }
+    for (int k = 0; k < 4; ++k) s[k] = acc[k];
+}
+
+namespace rng {
+    void seedThread(std::uint64_t seed, std::uint64_t stream) {
+        tl_engine = Xoshiro256(seed, stream);
+    }
+
+    Xoshiro256& engine() {
+        return tl_engine;
+    }
+
+    double uniform01() {
+        return static_cast<double>(tl_engine() >> 11) * 0x1.0p-53;
+    }
+
+    std::size_t uniformIndex(std::size_t bound) {
+        // Lemire's multiply-shift; the bias is below 2^-64 * bound
+        return static_cast<std::size_t>((static_cast<unsigned __int128>(tl_engine()) * bound) >> 64);
+    }
 }
 
 Graph::Graph(int numVertices) : numVertices(numVertices) {
@@ -52,14 +117,78 @@ State::~State() {
 }
 
 bool State::selectActionVertex(const Graph& graph) {
+    return selectActionVertex(graph, treePolicy::estimatePolicy);
+}
+
+bool State::selectActionVertex(const Graph& graph, const std::function<double(const State&, const Graph&, bool)>& estimate) {
+    if (possibleVertices.empty()) {
+        actionVertex = -1; // No valid vertex
+        return false;
+    }
+
+    std::vector<int> candidates;
+    maxDegreeCandidates(graph, candidates);
+
+    // Choose uniformly at random among candidates with maximum degree
+    if (candidates.empty()) {
+        // defensive fallback: pick any
+        auto it = possibleVertices.begin();
+        actionVertex = *it;
+        return true;
+    }
+    actionVertex = candidates[rng::uniformIndex(candidates.size())];
+
+    // Calculate estimated probability of including the action vertex
+    estProbInclude = estimate(*this, graph, true);
+
+    return true;
+}
+
+bool State::selectActionVertex(const Graph& graph,
+                               const std::function<void(const State&, const Graph&, std::vector<double>&,
+                                                        std::vector<double>&)>& batch,
+                               double refreshRatio) {
     if (possibleVertices.empty()) {
         actionVertex = -1; // No valid vertex
         return false;
     }
 
+    if (!priors || static_cast<double>(possibleVertices.size()) < refreshRatio * static_cast<double>(priorsResidualSize)) {
+        auto table = std::make_shared<std::vector<double>>(graph.numVertices, 0.5);
+        auto finalSolution = std::make_shared<std::vector<double>>();
+        batch(*this, graph, *table, *finalSolution);
+        priors = std::move(table);
+        warmStart = finalSolution->empty() ? nullptr : std::move(finalSolution);
+        priorsResidualSize = possibleVertices.size();
+    }
+    const std::vector<double>& p = *priors;
+
+    std::vector<int> candidates;
+    maxDegreeCandidates(graph, candidates);
+    if (candidates.empty()) {
+        actionVertex = *possibleVertices.begin();
+    } else {
+        // Most decisive prior among max-degree vertices, uniform among ties
+        double bestMargin = -1.0;
+        int ties = 0;
+        for (int u : candidates) {
+            double margin = std::fabs(p[u] - 0.5);
+            if (margin > bestMargin) {
+                bestMargin = margin;
+                ties = 0;
+            }
+            if (margin == bestMargin && rng::uniformIndex(++ties) == 0) actionVertex = u;
+        }
+    }
+    estProbInclude = p[actionVertex];
+
+    return true;
+}
+
+void State::maxDegreeCandidates(const Graph& graph, std::vector<int>& candidates) const {
     // Compute degree inside the induced subgraph of possible vertices
     int bestDeg = -1;
-    std::vector<int> candidates;
+    candidates.clear();
     candidates.reserve(possibleVertices.size());
     for (int u : possibleVertices) {
         int deg = 0;
@@ -74,21 +203,6 @@ bool State::selectActionVertex(const Graph& graph) {
             candidates.push_back(u);
         }
     }
-
-    // Choose uniformly at random among candidates with maximum degree
-    if (candidates.empty()) {
-        // defensive fallback: pick any
-        auto it = possibleVertices.begin();
-        actionVertex = *it;
-        return true;
-    }
-    std::uniform_int_distribution<size_t> dist(0, candidates.size() - 1);
-    actionVertex = candidates[dist(tl_engine)];
-
-    // Calculate estimated probability of including the action vertex
-    estProbInclude = treePolicy::estimatePolicy(*this, graph, true);
-
-    return true;
 }
 
 void State::include(int vertex) {
@@ -97,6 +211,8 @@ void State::include(int vertex) {
         isSelected[vertex] = true;
         selectedVertices.insert(vertex);
         possibleVertices.erase(vertex);
+        lpBound = -1.0;
+        lpMatching.reset();
     }
 }
 
@@ -104,12 +220,14 @@ void State::exclude(int vertex) {
     if (vertex >= 0 && vertex < static_cast<int>(isSelected.size())) {
         assert(possibleVertices.count(vertex) && "Error: excluding a vertex that is not in the possible set");
         possibleVertices.erase(vertex);
+        lpBound = -1.0;
+        lpMatching.reset();
     }
 }
 
 namespace treePolicy {
     Node* uctSampling(Node* node, double explorationParam) {
-        const std::vector<Node*>& children = node->children;
+        const ChildSlots& children = node->children;
         assert(!children.empty());
 
         // Compute state values
@@ -136,7 +254,7 @@ namespace treePolicy {
             w = sum;
         }
 
-        double r = tl_uniform01(tl_engine) * sum;
+        double r = rng::uniform01() * sum;
         for (std::size_t i = 0; i < weights.size(); ++i) {
             if (r <= weights[i]) return children[i];
         }
@@ -146,7 +264,7 @@ namespace treePolicy {
     }
 
     Node* epsilonGreedy(Node* node, double explorationParam) {
-        const std::vector<Node*>& children = node->children;
+        const ChildSlots& children = node->children;
         assert(!children.empty());
 
         // Compute state values
@@ -166,10 +284,10 @@ namespace treePolicy {
 
         // Epsilon-greedy selection
         double epsilon = 0.1; // Fixed epsilon value
-        double r = tl_uniform01(tl_engine);
+        double r = rng::uniform01();
         if (r < epsilon) {
             // Explore: random choice
-            std::size_t idx = static_cast<std::size_t>(tl_uniform01(tl_engine) * children.size());
+            std::size_t idx = static_cast<std::size_t>(rng::uniform01() * children.size());
             if (idx >= children.size()) idx = children.size() - 1;
             return children[idx];
         } else {
@@ -190,8 +308,13 @@ namespace treePolicy {
         estimatePolicy = policy;
     }
 
+    void setBatchEstimatePolicy(BatchEstimatePolicy policy, double refreshRatio) {
+        batchEstimatePolicy = std::move(policy);
+        priorRefreshRatio = refreshRatio;
+    }
+
     Node* puctArgmax(Node* node, const Graph& graph, double explorationParam) {
-        const std::vector<Node*>& children = node->children;
+        const ChildSlots& children = node->children;
         assert(!children.empty());
 
         int totalVisits = node->visits;
@@ -4,7 +4,11 @@
 #include <vector>
 #include <unordered_set>
 #include <cassert>
+#include <cstdint>
 #include <string>
+#include <functional>
+#include <memory>
+#include <utility>
 
 /**
  * @brief Represents an undirected graph.
@@ -40,6 +44,18 @@ public:
  */
 Graph loadGraphFromJson(const std::string& path);
 
+/**
+ * @brief Whole-residual structure kept for per-vertex estimators (see State::structure).
+ */
+struct ResidualStructure {
+    std::vector<int> coreNumber;    // core number per vertex of that residual (0 outside it)
+    std::vector<double> inverseDegree; // mean inverse residual degree of the neighbors, per vertex
+    std::vector<double> redundancy; // fraction of adjacent neighbor pairs, per vertex
+    int maxDegree = 0;              // max residual degree
+    int maxCore = 0;                // max core number
+    std::size_t residualSize = 0;   // |possibleVertices| when computed
+};
+
 /**
  * @brief Represents the state of selected vertices in the graph.
  */
@@ -76,6 +92,28 @@ public:
      */
     double estProbInclude;
 
+    /**
+     * @brief Exact LP relaxation optimum of the residual graph, recorded by the last
+     *        Rule 4 run (-1 if unknown; reset by include/exclude).
+     *
+     * When set, Rule 4 found nothing more to reduce, so x_v = 1/2 is an optimal LP
+     * solution for every possible vertex.
+     */
+    double lpBound = -1.0;
+
+    /**
+     * @brief Maximum matching of the bipartite doubling that gave lpBound, as (u_L, v_R)
+     *        pairs (nullptr whenever lpBound is unknown). Copies of the state share it;
+     *        exactLP starts its deletion bounds from it instead of matching from scratch.
+     */
+    std::shared_ptr<const std::vector<std::pair<int, int>>> lpMatching;
+
+    /**
+     * @brief Lower bound on the size of every cover that extends this state (selected
+     *        vertices included); inherited by children, which only raise it.
+     */
+    int lowerBound = 0;
+
     /**
      * @brief Selects a random action vertex from the possible vertices.
      * @param graph The graph to select the vertex from.
@@ -83,6 +121,56 @@ public:
      */
     bool selectActionVertex(const Graph& graph);
 
+    /**
+     * @brief Same as selectActionVertex(graph), with estProbInclude taken from `estimate`.
+     */
+    bool selectActionVertex(const Graph& graph, const std::function<double(const State&, const Graph&, bool)>& estimate);
+
+    /**
+     * @brief Include priors of all vertices from the last batch solve, indexed by vertex
+     *        (nullptr if none). Copies of the state share the table.
+     */
+    std::shared_ptr<const std::vector<double>> priors;
+
+    /**
+     * @brief Residual size (possibleVertices) when priors were computed.
+     */
+    std::size_t priorsResidualSize = 0;
+
+    /**
+     * @brief Final solution of the solve that produced priors (estimator-specific layout,
+     *        nullptr if none); the next solve in this subtree starts from it.
+     */
+    std::shared_ptr<const std::vector<double>> warmStart;
+
+    /**
+     * @brief Depth of the node holding this state (root = 0).
+     */
+    int depth = 0;
+
+    /**
+     * @brief Structure of an ancestor's residual (or this one's) for per-vertex estimators,
+     *        nullptr if none. Copies share it; estimators fill it through a const State
+     *        (hence mutable) while the node is being built, before other workers see it.
+     */
+    mutable std::shared_ptr<const ResidualStructure> structure;
+
+    /**
+     * @brief Selects the action vertex using batch priors.
+     *
+     * The inherited priors table is reused while the residual keeps at least
+     * refreshRatio of the vertices it had when the table was solved; otherwise
+     * `batch` is called once for the whole residual. Among max-degree vertices the
+     * one with the most decisive prior (largest |p - 1/2|) is chosen.
+     * @param batch Fills a numVertices-sized vector with include priors and may leave its
+     *        final solution in the second vector (read back through warmStart).
+     * @param refreshRatio Re-solve when |residual| < refreshRatio * priorsResidualSize.
+     */
+    bool selectActionVertex(const Graph& graph,
+                            const std::function<void(const State&, const Graph&, std::vector<double>&,
+                                                     std::vector<double>&)>& batch,
+                            double refreshRatio);
+
     /**
      * @brief Selects a vertex in the solution.
      * @param vertex The vertex to be included. It must not be already selected.
@@ -94,13 +182,84 @@ public:
      * @param vertex The vertex to be excluded.
      */
     void exclude(int vertex);
-    
+
+private:
+    /**
+     * @brief Residual vertices of maximum degree within the residual graph.
+     */
+    void maxDegreeCandidates(const Graph& graph, std::vector<int>& candidates) const;
+};
+
+/**
+ * @brief xoshiro256** pseudo-random generator (satisfies UniformRandomBitGenerator).
+ *
+ * Streams derived from the same seed are separated with jump(), which advances the
+ * state by 2^128 draws, so streams 0, 1, 2, ... never overlap in practice.
+ */
+class Xoshiro256 {
+public:
+    using result_type = std::uint64_t;
+
+    /**
+     * @brief Seeds stream `stream` of `seed` (state from splitmix64, then `stream` jumps).
+     */
+    explicit Xoshiro256(std::uint64_t seed = 0, std::uint64_t stream = 0);
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return ~static_cast<result_type>(0); }
+
+    /**
+     * @brief Next 64 random bits.
+     */
+    result_type operator()();
+
+    /**
+     * @brief Advances the state by 2^128 draws.
+     */
+    void jump();
+
+private:
+    std::uint64_t s[4];
 };
 
+namespace rng {
+    /**
+     * @brief Default seed of threads that were never seeded explicitly.
+     */
+    constexpr std::uint64_t kDefaultSeed = 0x5eed5eed5eed5eedULL;
+
+    /**
+     * @brief Reseeds the calling thread's generator to stream `stream` of `seed`.
+     *
+     * Threads that are never seeded get kDefaultSeed with a distinct stream per thread.
+     */
+    void seedThread(std::uint64_t seed, std::uint64_t stream);
+
+    /**
+     * @brief The calling thread's generator.
+     */
+    Xoshiro256& engine();
+
+    /**
+     * @brief Uniform double in [0, 1) with 53 random bits from the thread's generator.
+     */
+    double uniform01();
+
+    /**
+     * @brief Uniform integer in [0, bound) from the thread's generator (bound > 0).
+     */
+    std::size_t uniformIndex(std::size_t bound);
+}
+
 // Forward declaration to avoid circular include in headers
 class Node;
 
 namespace treePolicy {
+    /**
+     * @brief Prior estimator signature: (state, graph, include) -> prior of that branch.
+     */
+    using EstimatePolicy = std::function<double(const State&, const Graph&, bool)>;
+
     /**
      * @brief Samples a child node using the UCT formula.
      * @param node Pointer to the parent node.
@@ -130,6 +289,31 @@ namespace treePolicy {
      */
     void setEstimatePolicy(std::function<double(const State&, const Graph&, bool)> policy);
 
+    /**
+     * @brief Batch prior estimator: fills a numVertices-sized vector with the include prior
+     *        of every residual vertex from one solve (other entries are ignored). It may start
+     *        from state.warmStart (the previous solve in this subtree) and leave its own final
+     *        solution in the second vector for the next one (left empty: no warm start).
+     */
+    using BatchEstimatePolicy = std::function<void(const State&, const Graph&, std::vector<double>& prior,
+                                                   std::vector<double>& warmStart)>;
+
+    /**
+     * @brief Batch estimator used instead of estimatePolicy when set (empty by default).
+     */
+    inline BatchEstimatePolicy batchEstimatePolicy;
+
+    /**
+     * @brief Priors are re-solved once the residual drops below this fraction of the
+     *        residual they were solved on.
+     */
+    inline double priorRefreshRatio = 0.5;
+
+    /**
+     * @brief Sets the batch estimator (empty restores per-vertex estimatePolicy) and refresh ratio.
+     */
+    void setBatchEstimatePolicy(BatchEstimatePolicy policy, double refreshRatio = 0.5);
+
     /**
      * @brief Samples a child node using PUCT (Prioritized Upper Confidence Tree) strategy.
      * @param node Pointer to the parent node.
@@ -0,0 +1,264 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+#include <regex>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "../lib/estimator.hpp"
+#include "../lib/mcts.hpp"
+#include "../lib/node.hpp"
+#include "../lib/utils.hpp"
+
+// One timed repetition: operations done and the nanoseconds they took
+struct Rep {
+    double ns = 0.0;
+    long long ops = 1;
+};
+
+// A repetition body; untimed setup (state copies, trees) happens inside, around timed()
+using Body = std::function<Rep()>;
+
+// Times f as one repetition of `ops` operations
+template <class F>
+static Rep timed(long long ops, F&& f) {
+    auto t0 = std::chrono::steady_clock::now();
+    f();
+    auto t1 = std::chrono::steady_clock::now();
+    return {std::chrono::duration<double, std::nano>(t1 - t0).count(), ops};
+}
+
+// Warm-up and repetition settings shared by every benchmark
+struct BenchOptions {
+    int warmup = 2;             // untimed repetitions per (instance, benchmark)
+    int reps = 15;              // timed repetitions per (instance, benchmark)
+    double budgetMs = 2000.0;   // stop repeating past this time once 3 reps are in
+};
+
+// ns/op of every timed repetition of one benchmark over a tier's instances
+struct Samples {
+    std::string tier;
+    std::string bench;
+    std::vector<double> nsPerOp;
+};
+
+static std::vector<double>& samples_of(std::vector<Samples>& all, const std::string& tier, const std::string& bench) {
+    for (Samples& s : all) {
+        if (s.tier == tier && s.bench == bench) return s.nsPerOp;
+    }
+    all.push_back({tier, bench, {}});
+    return all.back().nsPerOp;
+}
+
+static void run_bench(const Body& body, const BenchOptions& opts, std::vector<double>& out) {
+    for (int i = 0; i < opts.warmup; ++i) body();
+    double spentMs = 0.0;
+    for (int i = 0; i < opts.reps; ++i) {
+        Rep r = body();
+        out.push_back(r.ns / static_cast<double>(std::max(1LL, r.ops)));
+        spentMs += r.ns / 1e6;
+        if (i >= 2 && spentMs > opts.budgetMs) break;
+    }
+}
+
+// Nearest-rank percentile of sorted values (q in [0, 1])
+static double percentile(const std::vector<double>& sorted, double q) {
+    if (sorted.empty()) return 0.0;
+    std::size_t rank = static_cast<std::size_t>(std::ceil(q * static_cast<double>(sorted.size())));
+    return sorted[std::min(sorted.size() - 1, rank > 0 ? rank - 1 : 0)];
+}
+
+static std::vector<std::string> load_manifest_inputs(const std::string& path) {
+    std::ifstream in(path);
+    if (!in) return {};
+    std::ostringstream ss; ss << in.rdbuf();
+    std::string s = ss.str();
+    std::regex reInput("\\\"input\\\"\\s*:\\s*\\\"([^\\\"]+)\\\"");
+    std::vector<std::string> inputs;
+    for (std::sregex_iterator it(s.begin(), s.end(), reInput), end; it != end; ++it) inputs.push_back((*it)[1]);
+    return inputs;
+}
+
+// Kernelization fixpoint from the full graph, as the MCTS root does it
+static State kernelized_root(const Graph& graph) {
+    State state(graph.numVertices);
+    while (kernelize(graph, state, graph.numVertices));
+    return state;
+}
+
+// Vertices in a fixed pseudo-random order (include/exclude benchmark)
+static std::vector<int> shuffled_vertices(int n) {
+    std::vector<int> order(n);
+    std::iota(order.begin(), order.end(), 0);
+    rng::seedThread(rng::kDefaultSeed, 0);
+    for (int i = n - 1; i > 0; --i) std::swap(order[i], order[rng::uniformIndex(i + 1)]);
+    return order;
+}
+
+// Benchmarks of one instance, appended to the tier's samples
+static void bench_instance(const std::string& tier, const std::string& input, const std::string& estimatorName,
+                           const std::vector<std::string>& only, const BenchOptions& opts,
+                           std::vector<Samples>& all) {
+    auto wanted = [&](const std::string& bench) {
+        return only.empty() || std::find(only.begin(), only.end(), bench) != only.end();
+    };
+    auto bench = [&](const std::string& name, const Body& body) {
+        if (wanted(name)) run_bench(body, opts, samples_of(all, tier, name));
+    };
+
+    bench("load", [&]() { return timed(1, [&]() { loadGraphFromJson(input); }); });
+
+    Graph graph = loadGraphFromJson(input);
+    const int n = graph.numVertices;
+
+    // Includes the first half of a shuffled vertex order and excludes the rest (vertices
+    // already dropped by an earlier include are skipped)
+    const std::vector<int> order = shuffled_vertices(n);
+    bench("include_exclude", [&]() {
+        State state(n);
+        long long ops = 0;
+        Rep r = timed(1, [&]() {
+            for (int i = 0; i < n; ++i) {
+                const int v = order[i];
+                if (!state.possibleVertices.count(v)) continue;
+                if (2 * i < n) state.include(v);
+                else state.exclude(v);
+                ++ops;
+            }
+        });
+        r.ops = ops;
+        return r;
+    });
+
+    bench("kernelize", [&]() {
+        State state(n);
+        return timed(1, [&]() { while (kernelize(graph, state, n)); });
+    });
+
+    // Instances the kernelization solves outright (e.g. hack) benchmark the unreduced graph
+    State root = kernelized_root(graph);
+    if (root.possibleVertices.empty()) root = State(n);
+
+    // Max-degree selection alone: a constant prior keeps the estimator out
+    const treePolicy::EstimatePolicy noPrior = [](const State&, const Graph&, bool) { return 0.5; };
+    bench("select_action", [&]() {
+        State state = root;
+        return timed(1, [&]() { state.selectActionVertex(graph, noPrior); });
+    });
+
+    const estimator::Registered* entry = estimator::find(estimatorName);
+    if (entry && entry->perVertex) {
+        State state = root;
+        state.selectActionVertex(graph, noPrior);
+        bench("estimator", [&]() { return timed(1, [&]() { entry->perVertex(state, graph, true); }); });
+    }
+    if (entry && entry->batch) {
+        bench("estimator[batch]", [&]() {
+            std::vector<double> prior(n, 0.5), warmStart;
+            return timed(1, [&]() { entry->batch(root, graph, prior, warmStart); });
+        });
+    }
+
+    // A short search gives the root children and visits for the tree policies
+    MCTS mcts(graph, 0.0, 1, rng::kDefaultSeed);
+    bench("simulate", [&]() { return timed(1, [&]() { mcts.simulate(mcts.root); }); });
+    for (int it = 0; it < 64 && mcts.root->expandable > 0; ++it) mcts.run();
+    if (!mcts.root->full() || mcts.root->visits == 0) return;
+
+    constexpr int kPicks = 1000;
+    bench("policy_egreedy", [&]() {
+        return timed(kPicks, [&]() { for (int i = 0; i < kPicks; ++i) treePolicy::epsilonGreedy(mcts.root, 0.1); });
+    });
+    bench("policy_uct", [&]() {
+        return timed(kPicks, [&]() { for (int i = 0; i < kPicks; ++i) treePolicy::uctSampling(mcts.root, 1.4); });
+    });
+    bench("policy_puct", [&]() {
+        return timed(kPicks, [&]() { for (int i = 0; i < kPicks; ++i) treePolicy::puctArgmax(mcts.root, graph, 1.0); });
+    });
+}
+
+int main(int argc, char** argv) {
+    // Microbenchmarks of the library hot paths, per dataset tier.
+    // --tiers <a,b,...> (default exact,small,large,huge,hack; data/<tier>/manifest.json) --instances <n>
+    // --bench <a,b,...> --estimator <name> --warmup <n> --reps <n> --budget-ms <ms> --csv <path>
+    std::vector<std::string> tiers = {"exact", "small", "large", "huge", "hack"};
+    std::vector<std::string> only;
+    std::string estimatorName = "lp";
+    std::string csvPath;
+    int instances = 3;
+    BenchOptions opts;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--tiers" && i + 1 < argc) {
+            tiers.clear();
+            std::stringstream list(argv[++i]);
+            std::string name;
+            while (std::getline(list, name, ',')) tiers.push_back(name);
+        } else if (arg == "--bench" && i + 1 < argc) {
+            std::stringstream list(argv[++i]);
+            std::string name;
+            while (std::getline(list, name, ',')) only.push_back(name);
+        } else if (arg == "--instances" && i + 1 < argc) {
+            instances = std::max(1, std::stoi(argv[++i]));
+        } else if (arg == "--estimator" && i + 1 < argc) {
+            estimatorName = argv[++i];
+            if (!estimator::find(estimatorName)) {
+                std::cerr << "Unknown --estimator: " << estimatorName << std::endl;
+                return 1;
+            }
+        } else if (arg == "--warmup" && i + 1 < argc) {
+            opts.warmup = std::max(0, std::stoi(argv[++i]));
+        } else if (arg == "--reps" && i + 1 < argc) {
+            opts.reps = std::max(1, std::stoi(argv[++i]));
+        } else if (arg == "--budget-ms" && i + 1 < argc) {
+            opts.budgetMs = std::stod(argv[++i]);
+        } else if (arg == "--csv" && i + 1 < argc) {
+            csvPath = argv[++i];
+        } else {
+            std::cerr << "Unknown argument: " << arg << std::endl;
+            return 1;
+        }
+    }
+    // The MCTS setup of the tree-policy benchmarks uses the same estimator
+    treePolicy::setEstimatePolicy(estimator::find(estimatorName)->perVertex);
+
+    std::vector<Samples> all;
+    for (const std::string& tier : tiers) {
+        std::vector<std::string> inputs = load_manifest_inputs("data/" + tier + "/manifest.json");
+        if (inputs.empty()) {
+            std::cerr << "Skipping tier " << tier << ": no data/" << tier << "/manifest.json" << std::endl;
+            continue;
+        }
+        if (static_cast<int>(inputs.size()) > instances) inputs.resize(instances);
+        for (const std::string& input : inputs) bench_instance(tier, input, estimatorName, only, opts, all);
+        std::cerr << "done " << tier << " (" << inputs.size() << " instances)" << std::endl;
+    }
+
+    std::ofstream csv;
+    if (!csvPath.empty()) {
+        csv.open(csvPath);
+        csv << "tier,bench,reps,median_ns,p95_ns,min_ns\n";
+    }
+    std::cout << std::left << std::setw(8) << "tier" << std::setw(18) << "bench" << std::right
+              << std::setw(6) << "reps" << std::setw(14) << "median_ns" << std::setw(14) << "p95_ns"
+              << std::setw(14) << "min_ns" << "\n";
+    std::cout << std::fixed << std::setprecision(0);
+    for (Samples& s : all) {
+        std::sort(s.nsPerOp.begin(), s.nsPerOp.end());
+        const double median = percentile(s.nsPerOp, 0.5);
+        const double p95 = percentile(s.nsPerOp, 0.95);
+        std::cout << std::left << std::setw(8) << s.tier << std::setw(18) << s.bench << std::right
+                  << std::setw(6) << s.nsPerOp.size() << std::setw(14) << median << std::setw(14) << p95
+                  << std::setw(14) << s.nsPerOp.front() << "\n";
+        if (csv) csv << s.tier << "," << s.bench << "," << s.nsPerOp.size() << "," << median << "," << p95
+                     << "," << s.nsPerOp.front() << "\n";
+    }
+    return 0;
+}
@@ -9,33 +9,57 @@
 #include <filesystem>
 #include <chrono>
 #include <iomanip>
+#include <functional>
+#include <memory>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include "../lib/estimator.hpp"
+#include "../lib/exact.hpp"
+#include "../lib/incumbent.hpp"
 #include "../lib/mcts.hpp"
+#include "../lib/parallel.hpp"
+#include "../lib/portfolio.hpp"
+#include "../lib/stats.hpp"
 #include "../lib/utils.hpp"
 
+static std::string make_bar(double ratio, int width) {
+    if (ratio < 0.0) ratio = 0.0; if (ratio > 1.0) ratio = 1.0;
+    int filled = static_cast<int>(ratio * width);
+    std::string bar;
+    bar.reserve(width + 2);
+    bar.push_back('[');
+    for (int i = 0; i < width; ++i) bar.push_back(i < filled ? '#' : '.');
+    bar.push_back(']');
+    return bar;
+}
+
 // Simple tqdm-like progress rendering for items and iterations
 static void render_progress(std::size_t itemIndex, std::size_t totalItems,
                             int iterIndex, int totalIters) {
-    auto makeBar = [](double ratio, int width) {
-        if (ratio < 0.0) ratio = 0.0; if (ratio > 1.0) ratio = 1.0;
-        int filled = static_cast<int>(ratio * width);
-        std::string bar;
-        bar.reserve(width + 2);
-        bar.push_back('[');
-        for (int i = 0; i < width; ++i) bar.push_back(i < filled ? '#' : '.');
-        bar.push_back(']');
-        return bar;
-    };
-
     double itemRatio = totalItems > 0 ? static_cast<double>(itemIndex + 1) / static_cast<double>(totalItems) : 1.0;
     double iterRatio = totalIters > 0 ? static_cast<double>(iterIndex) / static_cast<double>(totalIters) : 1.0;
-    std::string itemBar = makeBar(itemRatio, 20);
-    std::string iterBar = makeBar(iterRatio, 20);
+    std::string itemBar = make_bar(itemRatio, 20);
+    std::string iterBar = make_bar(iterRatio, 20);
 
     std::cout << "\ritems " << itemBar << " " << (itemIndex + 1) << "/" << totalItems
               << "  iters " << iterBar << " " << iterIndex << "/" << totalIters
               << std::flush;
 }
 
+// Aggregated progress across --jobs workers
+static void render_progress_jobs(std::size_t itemsDone, std::size_t totalItems,
+                                 long long itersDone, long long totalIters, int active, int jobs) {
+    double itemRatio = totalItems > 0 ? static_cast<double>(itemsDone) / static_cast<double>(totalItems) : 1.0;
+    double iterRatio = totalIters > 0 ? static_cast<double>(itersDone) / static_cast<double>(totalIters) : 1.0;
+    std::cout << "\ritems " << make_bar(itemRatio, 20) << " " << itemsDone << "/" << totalItems
+              << "  iters " << make_bar(iterRatio, 20) << " " << itersDone << "/" << totalIters
+              << "  workers " << active << "/" << jobs
+              << std::flush;
+}
+
 struct InstancePath {
     std::string input;
     std::string output;
@@ -88,7 +112,473 @@ static int max_depth_recursive(Node* node) {
     return best;
 }
 
-static double run_perf(const std::vector<InstancePath>& items, int iterations, double explorationParam, std::ostream& out) {
+// Nodes closed by their lower bound, summed over instances (indexed by depth)
+static std::mutex g_pruneMutex;
+static std::vector<long long> g_prunedPerDepth;
+
+// Rule 3 inclusions summed over instances, and those only the node-relative bound forces
+static std::atomic<long long> g_rule3{0};
+static std::atomic<long long> g_rule3Extra{0};
+
+// Adds one tree's prune and Rule 3 counts to the run totals and returns the tree's prunes
+static long long add_prunes(const MCTS& mcts) {
+    g_rule3 += mcts.kernelStats.rule3.load();
+    g_rule3Extra += mcts.kernelStats.rule3Extra.load();
+    std::vector<long long> perDepth = mcts.prunedPerDepth();
+    std::lock_guard<std::mutex> lock(g_pruneMutex);
+    if (g_prunedPerDepth.size() < perDepth.size()) g_prunedPerDepth.resize(perDepth.size(), 0);
+    long long total = 0;
+    for (std::size_t d = 0; d < perDepth.size(); ++d) {
+        g_prunedPerDepth[d] += perDepth[d];
+        total += perDepth[d];
+    }
+    return total;
+}
+
+// Per-phase search stats summed over instances (builds with -DMCTS_STATS)
+static std::mutex g_statsMutex;
+static stats::SearchStats g_stats;
+
+// Adds a tree's per-phase stats to the run totals and returns its --stats CSV rows
+static std::string add_stats(std::size_t idx, const stats::SearchStats& st) {
+    {
+        std::lock_guard<std::mutex> lock(g_statsMutex);
+        g_stats.merge(st);
+    }
+    std::ostringstream rows;
+    rows << std::fixed << std::setprecision(3);
+    for (int p = 0; p < stats::kNumPhases; ++p) {
+        const stats::PhaseTotals& t = st.phases[p];
+        rows << idx << "," << stats::phaseName(p) << "," << st.iterations << "," << t.calls << "," << t.nanos / 1e6
+             << "," << t.allocations << "," << t.removed;
+        // Hardware columns stay empty where they were not read
+        const bool counted = stats::countedPhase(p);
+        for (int c = 0; c < stats::kNumCounters; ++c) {
+            rows << ",";
+            if (counted && st.hasCounter(c)) rows << t.counters[c];
+        }
+        rows << ",";
+        if (counted && st.hasCounter(stats::Cycles) && st.hasCounter(stats::Instructions) && t.counters[stats::Cycles] > 0) {
+            rows << (double)t.counters[stats::Instructions] / (double)t.counters[stats::Cycles];
+        }
+        rows << "\n";
+    }
+    return rows.str();
+}
+
+// Search settings shared by every instance of a run
+struct PerfOptions {
+    int iterations = 10;            // MCTS iterations per instance
+    double explorationParam = 0.0;  // tree policy exploration parameter
+    int numThreads = 1;             // tree-parallel workers per instance
+    int kernelThreads = 1;          // threads for the Rule 4 matching
+    std::string sharedIncumbent;    // run id of the shared-memory incumbents ("" = off)
+    std::uint64_t seed = rng::kDefaultSeed; // seed of the search's random streams
+    bool pin = false;               // pin workers to CPUs following the host topology
+    bool prune = true;              // close nodes whose lower bound reaches the answer
+    bool exact = false;             // solve with BranchAndReduce instead of MCTS
+    double sampleMs = 10.0;         // anytime trace interval of tree searches (0 = off)
+    bool stats = false;             // per-phase stats CSV of tree searches (--stats)
+    bool hwCounters = false;        // hardware counters in the stats (--hw-counters)
+    std::vector<PortfolioMember> portfolio; // non-empty: run these configurations side by side
+    double deadlineSeconds = 0.0;   // portfolio / exact wall-clock budget per instance (0 = none)
+};
+
+// Library estimator by CLI name (empty function if unknown)
+static treePolicy::EstimatePolicy estimator_by_name(const std::string& name) {
+    const estimator::Registered* entry = estimator::find(name);
+    return entry ? entry->perVertex : treePolicy::EstimatePolicy();
+}
+
+// Batch counterpart of an estimator (empty function if it has none)
+static treePolicy::BatchEstimatePolicy batch_estimator_by_name(const std::string& name) {
+    const estimator::Registered* entry = estimator::find(name);
+    return entry ? entry->batch : treePolicy::BatchEstimatePolicy();
+}
+
+// Parses "policy[:c[:rollout[:estimator]]],..." with policy in {egreedy, uct, puct},
+// rollout in {greedy, random} and estimator a registered name (estimator::registry()).
+static bool parse_portfolio(const std::string& spec, std::vector<PortfolioMember>& members) {
+    std::stringstream list(spec);
+    std::string entry;
+    while (std::getline(list, entry, ',')) {
+        std::vector<std::string> fields;
+        std::stringstream parts(entry);
+        std::string field;
+        while (std::getline(parts, field, ':')) fields.push_back(field);
+        if (fields.empty() || fields.size() > 4) return false;
+
+        PortfolioMember m;
+        m.name = entry;
+        if (fields[0] == "egreedy") m.selection = SelectionPolicy::EpsilonGreedy;
+        else if (fields[0] == "uct") m.selection = SelectionPolicy::Uct;
+        else if (fields[0] == "puct") m.selection = SelectionPolicy::Puct;
+        else return false;
+        if (fields.size() > 1) m.explorationParam = std::stod(fields[1]);
+        if (fields.size() > 2) {
+            if (fields[2] == "greedy") m.rollout = RolloutPolicy::Greedy;
+            else if (fields[2] == "random") m.rollout = RolloutPolicy::RandomizedGreedy;
+            else return false;
+        }
+        if (fields.size() > 3) {
+            m.estimator = estimator_by_name(fields[3]);
+            if (!m.estimator) return false;
+        }
+        members.push_back(m);
+    }
+    return !members.empty();
+}
+
+// Per-instance outcome: CSV row plus timing breakdown
+struct InstanceResult {
+    std::string row;
+    double loadSecs = 0.0;
+    double kernelSecs = 0.0;
+    double iterSecs = 0.0;
+    double statsSecs = 0.0;
+    bool optimal = false;   // answer proven optimal (search stopped there)
+    double proofSecs = 0.0; // kernelization + search until the proof
+    int lowerBound = 0;     // global lower bound at the end
+    int answer = 0;
+    double timeToTargetMs = -1.0; // first answer improvement to UB <= truth_cover (-1: never / no tree)
+    double gapArea = -1.0;  // integral of (UB - LB) / UB over the trace, in ms (-1: no trace)
+    double bytesPerNode = -1.0; // MemoryReport::bytesPerNode of the tree (-1: no tree)
+    double peakRssMb = -1.0;    // process peak RSS after the instance (-1: unknown)
+    std::string summary;    // extra report line (portfolio mode)
+    std::string trace;      // trace CSV rows (tree searches with --sample-ms > 0)
+    std::string stats;      // per-phase stats CSV rows (tree searches with --stats)
+};
+
+// CSV tail shared by all modes: lower_bound,status,proof_ms,time_to_target_ms,gap_area,bytes_per_node,peak_rss_mb
+static std::string proof_columns(const InstanceResult& res) {
+    std::ostringstream cols;
+    cols << std::fixed << std::setprecision(3);
+    cols << "," << res.lowerBound << "," << (res.optimal ? "optimal" : "open") << ",";
+    if (res.optimal) cols << res.proofSecs * 1000.0;
+    cols << ",";
+    if (res.timeToTargetMs >= 0.0) cols << res.timeToTargetMs;
+    cols << ",";
+    if (res.gapArea >= 0.0) cols << res.gapArea;
+    cols << std::setprecision(1) << ",";
+    if (res.bytesPerNode >= 0.0) cols << res.bytesPerNode;
+    cols << ",";
+    if (res.peakRssMb >= 0.0) cols << res.peakRssMb;
+    return cols.str();
+}
+
+// Memory report of the largest tree of the run (by nodes) and the process peak RSS
+static std::mutex g_memoryMutex;
+static MemoryReport g_largestTree;
+static std::size_t g_peakRssBytes = 0;
+
+// Fills the memory columns of an instance from its tree and keeps the run's largest tree
+static void add_memory(const MCTS& mcts, InstanceResult& res) {
+    const MemoryReport report = mcts.memoryReport();
+    res.bytesPerNode = report.bytesPerNode();
+    if (report.peakRssBytes > 0) res.peakRssMb = report.peakRssBytes / (1024.0 * 1024.0);
+    std::lock_guard<std::mutex> lock(g_memoryMutex);
+    if (report.nodes > g_largestTree.nodes) g_largestTree = report;
+    g_peakRssBytes = std::max(g_peakRssBytes, report.peakRssBytes);
+}
+
+// One anytime sample of a tree search
+struct TraceSample {
+    double ms;          // since the root kernelization started
+    long long iteration;
+    int ub;             // answer
+    int lb;             // global lower bound
+    long long nodes;
+};
+
+// Samples a tree from a background thread every intervalMs until stop() (which takes a final sample).
+// samples[0] is `start` itself with the trivial bounds (UB = n, LB = 0)
+class TraceSampler {
+public:
+    TraceSampler(const MCTS& mcts, double intervalMs, std::chrono::steady_clock::time_point start)
+        : mcts(mcts), start(start) {
+        samples.push_back({0.0, 0, mcts.graph.numVertices, 0, 0});
+        take();
+        if (intervalMs > 0.0) {
+            thread = std::thread([this, intervalMs]() {
+                const auto interval = std::chrono::duration<double, std::milli>(intervalMs);
+                std::unique_lock<std::mutex> lock(mutex);
+                while (!cv.wait_for(lock, interval, [this]() { return stopping; })) take();
+            });
+        }
+    }
+
+    ~TraceSampler() { stop(); }
+
+    void stop() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (stopping) return;
+            stopping = true;
+        }
+        cv.notify_all();
+        if (thread.joinable()) thread.join();
+        take();
+    }
+
+    std::vector<TraceSample> samples;
+
+private:
+    void take() {
+        const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        const int ub = mcts.answer;
+        // Bounds only rise, so a proof read here is complete
+        const int lb = mcts.optimal() ? ub : std::min(ub, mcts.lowerBound());
+        samples.push_back({ms, mcts.iterationCount.load(), ub, lb, mcts.nodeCount.load()});
+    }
+
+    const MCTS& mcts;
+    std::chrono::steady_clock::time_point start;
+    std::thread thread;
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool stopping = false;
+};
+
+// Answer improvements of a tree in ms since start, in time order
+static std::vector<std::pair<double, int>> improvements_since(const MCTS& mcts,
+                                                              std::chrono::steady_clock::time_point start) {
+    std::vector<std::pair<double, int>> improvements;
+    for (const AnswerImprovement& h : mcts.answerHistory()) {
+        improvements.push_back({std::chrono::duration<double, std::milli>(h.time - start).count(), h.answer});
+    }
+    std::sort(improvements.begin(), improvements.end());
+    return improvements;
+}
+
+// When the answer first reached target (-1: never)
+static double time_to_target(const std::vector<std::pair<double, int>>& improvements, int target) {
+    if (target < 0) return -1.0;
+    for (const auto& [ms, answer] : improvements) {
+        if (answer <= target) return ms;
+    }
+    return -1.0;
+}
+
+// Area under the relative gap (UB - LB) / UB from samples[0] to the last sample. UB steps at
+// every answer improvement and LB at every sample, so the curve is exact in UB and piecewise
+// constant in LB
+static double gap_area(const std::vector<TraceSample>& samples, const std::vector<std::pair<double, int>>& improvements) {
+    if (samples.empty()) return 0.0;
+    const double end = samples.back().ms;
+    double area = 0.0;
+    double t = samples[0].ms;
+    int ub = samples[0].ub;
+    int lb = samples[0].lb;
+    std::size_t i = 1, j = 0;
+    while (t < end) {
+        const double nextSample = i < samples.size() ? samples[i].ms : end;
+        const double nextImprovement = j < improvements.size() ? improvements[j].first : end;
+        const double next = std::min(end, std::min(nextSample, nextImprovement));
+        if (ub > 0) area += (next - t) * std::max(0, ub - lb) / static_cast<double>(ub);
+        t = next;
+        for (; i < samples.size() && samples[i].ms <= t; ++i) {
+            ub = std::min(ub, samples[i].ub);
+            lb = samples[i].lb;
+        }
+        for (; j < improvements.size() && improvements[j].first <= t; ++j) ub = std::min(ub, improvements[j].second);
+    }
+    return area;
+}
+
+// Load, search and summarize one manifest instance.
+// onIteration(it) reports the number of iterations completed so far for this instance.
+static InstanceResult run_instance(std::size_t idx, const InstancePath& item, const PerfOptions& opts,
+                                   const std::function<void(int)>& onIteration) {
+    const int iterations = opts.iterations;
+    InstanceResult res;
+    auto tLoadStart = std::chrono::steady_clock::now();
+    Graph g = loadGraphFromJson(item.input);
+    auto tLoadEnd = std::chrono::steady_clock::now();
+    res.loadSecs = std::chrono::duration<double>(tLoadEnd - tLoadStart).count();
+
+    // Shared-memory incumbent keyed by run id and instance hash (other perf_mcts processes on this host)
+    std::unique_ptr<SharedIncumbent> shared;
+    if (!opts.sharedIncumbent.empty()) {
+        shared = SharedIncumbent::open(g, opts.sharedIncumbent);
+        if (!shared) std::cerr << "warning: shared incumbent unavailable for " << item.input << "\n";
+    }
+
+    if (opts.exact) {
+        ExactOptions eopts;
+        eopts.deadlineSeconds = opts.deadlineSeconds;
+        eopts.kernelThreads = opts.kernelThreads;
+        eopts.seed = opts.seed;
+        BranchAndReduce solver(g, eopts);
+        ExactResult eres = solver.solve();
+        res.kernelSecs = eres.rootKernelSeconds;
+        res.iterSecs = eres.seconds - eres.rootKernelSeconds;
+        res.optimal = eres.optimal;
+        res.proofSecs = eres.seconds;
+        res.answer = eres.answer;
+        res.lowerBound = eres.optimal ? eres.answer : eres.rootLowerBound;
+        onIteration(iterations);
+
+        // Same columns as a tree: the search tree of the DFS (root_children 2 once it branches)
+        int truth = load_output_size(item.output);
+        std::ostringstream row;
+        row << idx << "," << g.numVertices << "," << count_edges(g) << "," << (eres.nodes > 1 ? 2 : 0)
+            << "," << eres.nodes << "," << eres.maxDepth + 1 << "," << eres.answer << "," << truth
+            << "," << std::fixed << std::setprecision(3) << res.kernelSecs * 1000.0
+            << "," << eres.pruned << proof_columns(res) << "\n";
+        res.row = row.str();
+
+        std::ostringstream summary;
+        summary << "exact | nodes=" << eres.nodes << " pruned=" << eres.pruned << " root_lb=" << eres.rootLowerBound
+                << " best_at=" << std::fixed << std::setprecision(3) << eres.bestSeconds << "s";
+        res.summary = summary.str();
+        return res;
+    }
+
+    if (!opts.portfolio.empty()) {
+        PortfolioOptions popts;
+        popts.deadlineSeconds = opts.deadlineSeconds;
+        popts.maxIterations = iterations;
+        popts.kernelThreads = opts.kernelThreads;
+        popts.seed = opts.seed;
+        popts.placement = opts.pin ? Placement::Scatter : Placement::None;
+        popts.incumbent = shared.get();
+        Portfolio portfolio(g, opts.portfolio, popts);
+        PortfolioResult pres = portfolio.run();
+        res.kernelSecs = pres.rootKernelSeconds;
+        res.iterSecs = pres.seconds - pres.rootKernelSeconds;
+        onIteration(iterations);
+
+        // Tree stats of the member that proved optimality, else of the first one holding the best answer
+        auto tStatsStart = std::chrono::steady_clock::now();
+        std::size_t lead = 0;
+        if (pres.prover >= 0) {
+            lead = pres.prover;
+        } else {
+            lead = std::min_element(pres.answers.begin(), pres.answers.end()) - pres.answers.begin();
+        }
+        const MCTS* tree = portfolio.tree(lead);
+        int truth = load_output_size(item.output);
+        res.optimal = pres.optimal;
+        res.proofSecs = pres.seconds;
+        res.answer = pres.answer;
+        res.lowerBound = pres.optimal ? pres.answer : tree->lowerBound();
+        add_memory(*tree, res);
+        std::ostringstream row;
+        row << idx << "," << g.numVertices << "," << count_edges(g) << "," << tree->root->children.size()
+            << "," << count_nodes_recursive(tree->root) << "," << max_depth_recursive(tree->root)
+            << "," << pres.answer << "," << truth
+            << "," << std::fixed << std::setprecision(3) << res.kernelSecs * 1000.0
+            << "," << add_prunes(*tree) << proof_columns(res) << "\n";
+        res.row = row.str();
+        if (opts.stats) {
+            stats::SearchStats st;
+            for (std::size_t i = 0; i < opts.portfolio.size(); ++i) st.merge(portfolio.tree(i)->stats());
+            res.stats = add_stats(idx, st);
+        }
+        res.statsSecs = std::chrono::duration<double>(std::chrono::steady_clock::now() - tStatsStart).count();
+
+        std::ostringstream summary;
+        summary << "portfolio | " << (pres.optimal ? "optimal by " + opts.portfolio[pres.prover].name : std::string("no proof"))
+                << " | answer=" << pres.answer << " |";
+        for (std::size_t i = 0; i < opts.portfolio.size(); ++i) {
+            summary << " " << opts.portfolio[i].name << "=" << pres.answers[i] << "/" << pres.iterations[i] << "it";
+        }
+        res.summary = summary.str();
+        return res;
+    }
+
+    // Constructing MCTS runs the root kernelization (Rules 1-4 to fixpoint)
+    auto tKernelStart = std::chrono::steady_clock::now();
+    MCTS mcts(g, opts.explorationParam, opts.kernelThreads, opts.seed);
+    auto tKernelEnd = std::chrono::steady_clock::now();
+    res.kernelSecs = std::chrono::duration<double>(tKernelEnd - tKernelStart).count();
+    if (shared) mcts.setSharedIncumbent(shared.get());
+    mcts.pruning = opts.prune;
+
+    // Run and accumulate reward after each iteration
+    std::unique_ptr<TraceSampler> sampler;
+    if (opts.sampleMs > 0.0) sampler = std::make_unique<TraceSampler>(mcts, opts.sampleMs, tKernelStart);
+    auto tIterStart = std::chrono::steady_clock::now();
+    const bool hasDeadline = opts.deadlineSeconds > 0.0;
+    const auto deadline = tKernelStart + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::duration<double>(opts.deadlineSeconds));
+    if (opts.numThreads > 1) {
+        // Tree-parallel: all workers grow the same tree; progress shown on completion
+        mcts.runParallel(iterations, opts.numThreads, opts.pin ? Placement::Compact : Placement::None,
+                         hasDeadline ? std::max(0.0, std::chrono::duration<double>(deadline - tIterStart).count()) : 0.0);
+    } else {
+        for (int it = 0; it < iterations; ++it) {
+            if (mcts.optimal()) {
+                // Fully expanded or proven optimal, no need to continue
+                break;
+            }
+            if (hasDeadline && std::chrono::steady_clock::now() >= deadline) break;
+            mcts.run();
+            onIteration(it + 1);
+        }
+    }
+    auto tIterEnd = std::chrono::steady_clock::now();
+    res.iterSecs = std::chrono::duration<double>(tIterEnd - tIterStart).count();
+    if (sampler) sampler->stop();
+
+    // Final tree stats
+    auto tStatsStart = std::chrono::steady_clock::now();
+    int rootChildren = (int)mcts.root->children.size();
+    int totalNodes = count_nodes_recursive(mcts.root);
+    int maxDepth = max_depth_recursive(mcts.root);
+    int estCover = mcts.answer;
+    int truth = load_output_size(item.output);
+    long long pruned = add_prunes(mcts);
+    res.optimal = mcts.optimal();
+    res.proofSecs = res.kernelSecs + res.iterSecs;
+    res.answer = estCover;
+    res.lowerBound = res.optimal ? estCover : mcts.lowerBound();
+    const std::vector<std::pair<double, int>> improvements = improvements_since(mcts, tKernelStart);
+    res.timeToTargetMs = time_to_target(improvements, truth);
+    if (sampler) {
+        res.gapArea = gap_area(sampler->samples, improvements);
+        std::ostringstream trace;
+        trace << std::fixed << std::setprecision(3);
+        for (const TraceSample& s : sampler->samples) {
+            trace << idx << "," << s.ms << "," << s.iteration << "," << s.ub << "," << s.lb << "," << s.nodes << "\n";
+        }
+        res.trace = trace.str();
+    }
+    if (opts.stats) res.stats = add_stats(idx, mcts.stats());
+    add_memory(mcts, res);
+    auto tStatsEnd = std::chrono::steady_clock::now();
+    res.statsSecs = std::chrono::duration<double>(tStatsEnd - tStatsStart).count();
+
+    std::ostringstream row;
+    row << idx << "," << g.numVertices << "," << count_edges(g) << "," << rootChildren
+        << "," << totalNodes << "," << maxDepth << "," << estCover << "," << truth
+        << "," << std::fixed << std::setprecision(3) << res.kernelSecs * 1000.0 << "," << pruned << proof_columns(res) << "\n";
+    res.row = row.str();
+    return res;
+}
+
+static void print_timing(const InstanceResult& res, int iterations, double cumulativeSeconds) {
+    double avgIterSecs = iterations > 0 ? res.iterSecs / (double)iterations : 0.0;
+    // Print per-instance timing breakdown with cumulative seconds
+    std::cout << std::fixed << std::setprecision(3)
+              << "timing | load=" << res.loadSecs << "s"
+              << " kernel=" << res.kernelSecs << "s"
+              << " iter=" << res.iterSecs << "s (avg=" << avgIterSecs << "s)"
+              << " stats=" << res.statsSecs << "s"
+              << " | cum=" << cumulativeSeconds << "s";
+    if (res.optimal) std::cout << " | optimal " << res.answer << " proven in " << res.proofSecs << "s";
+    else std::cout << " | open lb=" << res.lowerBound << " ub=" << res.answer;
+    std::cout << "\n";
+    if (!res.summary.empty()) std::cout << res.summary << "\n";
+}
+
+static const char* kCsvHeader = "idx,n,edges,root_children,total_nodes,max_depth,est_cover,truth_cover,root_kernel_ms,pruned,lower_bound,status,proof_ms,time_to_target_ms,gap_area,bytes_per_node,peak_rss_mb\n";
+static const char* kTraceHeader = "idx,elapsed_ms,iteration,ub,lb,nodes\n";
+static const char* kStatsHeader = "idx,phase,iterations,calls,ms,allocations,removed,cycles,instructions,l1d_misses,llc_misses,branch_misses,ipc\n";
+
+static double run_perf(const std::vector<InstancePath>& items, const PerfOptions& opts, std::ostream& out,
+                       std::ostream* trace, std::ostream* statsOut) {
+    const int iterations = opts.iterations;
     // CSV header for per-instance metrics
     // idx: instance index in manifest
     // n: number of vertices
@@ -97,68 +587,127 @@ static double run_perf(const std::vector<InstancePath>& items, int iterations, d
     // total_nodes: total nodes in the MCTS tree (root + all descendants)
     // est_cover: estimated cover size from simulate(best)
     // truth_cover: ground-truth cover size from dataset output
-    out << "idx,n,edges,root_children,total_nodes,max_depth,est_cover,truth_cover\n";
-
-    // Track average reward per iteration across instances
-    std::vector<double> avgRewards(iterations, 0.0);
-    std::vector<int> counts(iterations, 0);
+    // root_kernel_ms: root kernelization time (MCTS construction)
+    // pruned: nodes closed because their lower bound reached the answer
+    // lower_bound: global lower bound (root bound; est_cover once proven)
+    // status: optimal (the search stopped at the proof) or open
+    // proof_ms: kernelization + search time until the proof (empty when open)
+    // time_to_target_ms: when the answer first reached truth_cover, since the root kernelization started (tree searches)
+    // gap_area: integral of the relative gap (UB - LB) / UB from the root kernelization start, in ms (--sample-ms)
+    // bytes_per_node: tree memory (nodes, states, prior tables) per node (MCTS::memoryReport)
+    // peak_rss_mb: process peak RSS after the instance (monotone over a run; shared by --jobs workers)
+    out << kCsvHeader;
+    if (trace) *trace << kTraceHeader;
+    if (statsOut) *statsOut << kStatsHeader;
 
     double cumulativeSeconds = 0.0;
 
     for (size_t i = 0; i < items.size(); ++i) {
-        auto tLoadStart = std::chrono::steady_clock::now();
-        Graph g = loadGraphFromJson(items[i].input);
-        auto tLoadEnd = std::chrono::steady_clock::now();
-        double loadSecs = std::chrono::duration<double>(tLoadEnd - tLoadStart).count();
-
-        MCTS mcts(g, explorationParam);
-
-        // Run and accumulate reward after each iteration
-        auto tIterStart = std::chrono::steady_clock::now();
-        for (int it = 0; it < iterations; ++it) {
-            if (mcts.root->expandable == 0) {
-                // Fully expanded, no need to continue
-                break;
-            }
-            mcts.run();
+        InstanceResult res = run_instance(i, items[i], opts, [&](int it) {
             // tqdm-like progress update for current item
-            render_progress(i, items.size(), it + 1, iterations);
-        }
-        auto tIterEnd = std::chrono::steady_clock::now();
-        double iterSecs = std::chrono::duration<double>(tIterEnd - tIterStart).count();
+            render_progress(i, items.size(), it, iterations);
+        });
         // Ensure full progress shown for the item before stats
         render_progress(i, items.size(), iterations, iterations);
         std::cout << "\n"; // end progress line for timing output
 
-        // Final tree stats
-        auto tStatsStart = std::chrono::steady_clock::now();
-        int rootChildren = (int)mcts.root->children.size();
-        int totalNodes = count_nodes_recursive(mcts.root);
-        int maxDepth = max_depth_recursive(mcts.root);
-        int estCover = mcts.answer;
-        int truth = load_output_size(items[i].output);
-        auto tStatsEnd = std::chrono::steady_clock::now();
-        double statsSecs = std::chrono::duration<double>(tStatsEnd - tStatsStart).count();
-
-        cumulativeSeconds += loadSecs + iterSecs + statsSecs;
-        double avgIterSecs = iterations > 0 ? iterSecs / (double)iterations : 0.0;
-
-        // Print per-instance timing breakdown with cumulative seconds
-        std::cout << std::fixed << std::setprecision(3)
-                  << "timing | load=" << loadSecs << "s"
-                  << " iter=" << iterSecs << "s (avg=" << avgIterSecs << "s)"
-                  << " stats=" << statsSecs << "s"
-                  << " | cum=" << cumulativeSeconds << "s\n";
+        cumulativeSeconds += res.loadSecs + res.iterSecs + res.statsSecs;
+        print_timing(res, iterations, cumulativeSeconds);
 
-        out << i << "," << g.numVertices << "," << count_edges(g) << "," << rootChildren
-            << "," << totalNodes << "," << maxDepth << "," << estCover << "," << truth << "\n";
+        out << res.row;
         out << std::flush;
+        if (trace) *trace << res.trace << std::flush;
+        if (statsOut) *statsOut << res.stats << std::flush;
     }
     // Finish progress line
     std::cout << "\n";
     return cumulativeSeconds;
 }
 
+// --jobs mode: instances run concurrently on a work-stealing pool.
+// Instances start largest-first (input file size as cost proxy) so huge graphs
+// do not straggle; rows are written in manifest order through a reorder buffer.
+// Returns wall-clock seconds.
+static double run_perf_jobs(const std::vector<InstancePath>& items, const PerfOptions& opts, int jobs,
+                            std::ostream& out, std::ostream* trace, std::ostream* statsOut) {
+    const int iterations = opts.iterations;
+    out << kCsvHeader;
+    if (trace) *trace << kTraceHeader;
+    if (statsOut) *statsOut << kStatsHeader;
+
+    const std::size_t total = items.size();
+    std::vector<std::uintmax_t> cost(total, 0);
+    for (std::size_t i = 0; i < total; ++i) {
+        std::error_code ec;
+        cost[i] = std::filesystem::file_size(items[i].input, ec);
+        if (ec) cost[i] = 0;
+    }
+    std::vector<std::size_t> order(total);
+    for (std::size_t i = 0; i < total; ++i) order[i] = i;
+    std::stable_sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b) { return cost[a] > cost[b]; });
+
+    // Reorder buffer, filled by workers and drained in manifest order by the main thread
+    std::mutex bufferMutex;
+    std::vector<InstanceResult> results(total);
+    std::vector<char> ready(total, 0);
+    std::size_t nextToWrite = 0;
+
+    std::atomic<long long> itersDone(0);
+    std::atomic<int> itemsDone(0);
+    std::atomic<int> active(0);
+
+    auto tStart = std::chrono::steady_clock::now();
+    double cumulativeSeconds = 0.0;
+    {
+        // Each job worker owns a disjoint CPU slice; its instance's --threads are placed inside it
+        WorkStealingPool pool(opts.pin ? CpuTopology::host().partition(jobs)
+                                       : std::vector<std::vector<int>>(jobs));
+        for (std::size_t idx : order) {
+            pool.submit([&, idx]() {
+                active++;
+                int reported = 0;
+                InstanceResult res = run_instance(idx, items[idx], opts, [&](int it) {
+                    itersDone += it - reported;
+                    reported = it;
+                });
+                itersDone += iterations - reported; // early-terminated instances count as done
+                active--;
+                std::lock_guard<std::mutex> lock(bufferMutex);
+                results[idx] = std::move(res);
+                ready[idx] = 1;
+                itemsDone++;
+            });
+        }
+
+        const long long totalIters = static_cast<long long>(iterations) * static_cast<long long>(total);
+        while (nextToWrite < total) {
+            {
+                std::lock_guard<std::mutex> lock(bufferMutex);
+                bool printed = false;
+                while (nextToWrite < total && ready[nextToWrite]) {
+                    const InstanceResult& res = results[nextToWrite];
+                    if (!printed) std::cout << "\r" << std::string(100, ' ') << "\r";
+                    printed = true;
+                    cumulativeSeconds += res.loadSecs + res.iterSecs + res.statsSecs;
+                    std::cout << "[" << nextToWrite << "] ";
+                    print_timing(res, iterations, cumulativeSeconds);
+                    out << res.row;
+                    if (trace) *trace << res.trace;
+                    if (statsOut) *statsOut << res.stats;
+                    ++nextToWrite;
+                }
+                if (printed) out << std::flush;
+                if (printed && trace) *trace << std::flush;
+                if (printed && statsOut) *statsOut << std::flush;
+            }
+            render_progress_jobs(itemsDone, total, itersDone, totalIters, active, jobs);
+            if (nextToWrite < total) std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        }
+    }
+    std::cout << "\n";
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - tStart).count();
+}
+
 // ======= heuristic ======== //
 /* void init_estimate_policy() {
     treePolicy::setEstimatePolicy([](const State& state, const Graph& graph, bool include) {
@@ -225,103 +774,10 @@ static double run_perf(const std::vector<InstancePath>& items, int iterations, d
 } */
 
 // ======= perturbation-LP estimator ======== //
+// Lives in src/lib/estimator.cpp: all trials are solved as one batch with one SIMD lane
+// per trial (parameters and optional thread pool in estimator::perturbationLPConfig).
 void init_estimate_policy() {
-    treePolicy::setEstimatePolicy([](const State& state, const Graph& graph, bool include) {
-        // Perturbation-LP estimator:
-        // Repeatedly solve a perturbed LP relaxation of MVC on the current active core,
-        // then estimate probability by frequency of x_v > 0.5.
-        double prob = 0.5;
-
-        const int v = state.actionVertex;
-        if (v >= 0 && v < graph.numVertices && state.possibleVertices.count(v)) {
-            // Build active vertex index mapping for current core
-            std::vector<int> activeVerts;
-            activeVerts.reserve(state.possibleVertices.size());
-            std::vector<int> idxOf(graph.numVertices, -1);
-            for (int u : state.possibleVertices) {
-                idxOf[u] = static_cast<int>(activeVerts.size());
-                activeVerts.push_back(u);
-            }
-
-            const int n = static_cast<int>(activeVerts.size());
-            const int actionIdx = idxOf[v];
-            if (n > 0 && actionIdx >= 0) {
-                // Build edge list in active core (u < w) using local indices
-                std::vector<std::pair<int, int>> activeEdges;
-                for (int uGlobal : activeVerts) {
-                    int u = idxOf[uGlobal];
-                    for (int wGlobal : graph.adjacencyList[uGlobal]) {
-                        int w = (wGlobal >= 0 && wGlobal < graph.numVertices) ? idxOf[wGlobal] : -1;
-                        if (w >= 0 && u < w) activeEdges.push_back({u, w});
-                    }
-                }
-
-                if (!activeEdges.empty()) {
-                    // Solve perturbed LP approximately via projected gradient on
-                    // min sum_i c_i x_i + mu * sum_(u,w) [max(0, 1 - x_u - x_w)]^2, 0<=x_i<=1
-                    auto solvePerturbedLP = [&](int trial) {
-                        std::vector<double> c(n, 1.0);
-                        constexpr double delta = 0.20;
-                        for (int i = 0; i < n; ++i) {
-                            int vg = activeVerts[i];
-                            double phase = static_cast<double>((vg + 1) * 131 + (trial + 1) * 977);
-                            c[i] = 1.0 + delta * std::sin(phase);
-                        }
-
-                        std::vector<double> x(n, 0.5);
-                        constexpr int kIters = 140;
-                        constexpr double lr = 0.03;
-                        constexpr double mu = 8.0;
-
-                        for (int it = 0; it < kIters; ++it) {
-                            std::vector<double> grad = c;
-                            for (const auto& e : activeEdges) {
-                                int a = e.first;
-                                int b = e.second;
-                                double viol = 1.0 - x[a] - x[b];
-                                if (viol > 0.0) {
-                                    double g = -2.0 * mu * viol;
-                                    grad[a] += g;
-                                    grad[b] += g;
-                                }
-                            }
-                            for (int i = 0; i < n; ++i) {
-                                x[i] -= lr * grad[i];
-                                if (x[i] < 0.0) x[i] = 0.0;
-                                if (x[i] > 1.0) x[i] = 1.0;
-                            }
-                        }
-
-                        // quick feasibility repair for tiny residual violations
-                        for (const auto& e : activeEdges) {
-                            int a = e.first;
-                            int b = e.second;
-                            double deficit = 1.0 - x[a] - x[b];
-                            if (deficit > 0.0) {
-                                double add = 0.5 * deficit;
-                                x[a] = std::min(1.0, x[a] + add);
-                                x[b] = std::min(1.0, x[b] + add);
-                            }
-                        }
-
-                        return x;
-                    };
-
-                    constexpr int kTrials = 12;
-                    int greaterHalf = 0;
-                    for (int t = 0; t < kTrials; ++t) {
-                        std::vector<double> x = solvePerturbedLP(t);
-                        if (x[actionIdx] > 0.5) ++greaterHalf;
-                    }
-
-                    prob = static_cast<double>(greaterHalf) / static_cast<double>(kTrials);
-                    prob = std::max(0.05, std::min(0.95, prob));
-                }
-            }
-        }
-
-        return include ? prob : 1 - prob;
-    });
+    treePolicy::setEstimatePolicy(estimator::perturbationLP);
 }
 
 // ====== randomized rounding estimator ======== //
@@ -402,117 +858,216 @@ void init_estimate_policy() {
 } */
 
 // ====== MCMC Gibbs sampling estimator ====== //
-/* void init_estimate_policy() {
-	treePolicy::setEstimatePolicy([](const State& state, const Graph& graph, bool include) {
-        // Strategy #6 (Gibbs / MCMC):
-        // Sample feasible vertex covers S from P(S) ∝ exp(-beta * |S|)
-        // and estimate p_v = Pr[v in S].
-        double prob = 0.5;
+// Moved to the library: estimator::gibbs / estimator::gibbsBatch (--estimator gibbs).
 
-        const int v = state.actionVertex;
-        if (v >= 0 && v < graph.numVertices && state.possibleVertices.count(v)) {
-            // Active core indexing
-            std::vector<int> activeVerts;
-            activeVerts.reserve(state.possibleVertices.size());
-            std::vector<int> idxOf(graph.numVertices, -1);
-            for (int u : state.possibleVertices) {
-                idxOf[u] = static_cast<int>(activeVerts.size());
-                activeVerts.push_back(u);
-            }
 
-            const int n = static_cast<int>(activeVerts.size());
-            const int actionIdx = idxOf[v];
-            if (n > 0 && actionIdx >= 0) {
-                // Build local adjacency on active core
-                std::vector<std::vector<int>> localAdj(n);
-                int edgeCount = 0;
-                for (int ug : activeVerts) {
-                    int u = idxOf[ug];
-                    for (int vg : graph.adjacencyList[ug]) {
-                        int w = (vg >= 0 && vg < graph.numVertices) ? idxOf[vg] : -1;
-                        if (w >= 0) {
-                            localAdj[u].push_back(w);
-                            if (u < w) ++edgeCount;
-                        }
-                    }
-                }
+// Sequential stopping report: trials/samples used against the fixed budgets
+static void print_budgets(const std::vector<estimator::BudgetStats::Row>& rows) {
+    for (const auto& r : rows) {
+        std::cout << "adaptive budget | " << r.estimator << " calls=" << r.calls
+                  << " early=" << std::fixed << std::setprecision(1) << 100.0 * r.earlyCalls / r.calls << "%"
+                  << " used=" << (double)r.used / r.calls << "/" << (double)r.budget / r.calls
+                  << " saved=" << 100.0 * (1.0 - (double)r.used / r.budget) << "% of trials\n";
+    }
+}
 
-                if (edgeCount == 0) {
-                    prob = 0.01; // no edge pressure => typically excluded
-                } else {
-                    // Start from a feasible cover: all active vertices selected
-                    std::vector<bool> selected(n, true);
-
-                    auto canRemove = [&](int i) {
-                        // Removing i keeps feasibility iff every incident edge (i, j)
-                        // is still covered by j being selected.
-                        for (int j : localAdj[i]) {
-                            if (!selected[j]) return false;
-                        }
-                        return true;
-                    };
-
-                    constexpr double beta = 1.6; // larger => more mass on smaller covers
-                    const double addAcceptProb = std::exp(-beta); // 0->1 acceptance
-                    constexpr int burnIn = 400;
-                    constexpr int totalSteps = 2200;
-                    constexpr int sampleStride = 6;
-
-                    std::mt19937 rng(static_cast<unsigned int>(
-                        20260401u + static_cast<unsigned int>(v) * 1009u + static_cast<unsigned int>(n) * 9176u));
-                    std::uniform_int_distribution<int> pickVertex(0, n - 1);
-                    std::uniform_real_distribution<double> unif01(0.0, 1.0);
+// Rule 3 inclusions over the whole run
+static void print_rule3() {
+    if (g_rule3 == 0) return;
+    std::cout << "rule 3 | inclusions=" << g_rule3 << " beyond degree > answer=" << g_rule3Extra << "\n";
+}
 
-                    int hit = 0;
-                    int sampled = 0;
-                    for (int step = 0; step < totalSteps; ++step) {
-                        int i = pickVertex(rng);
-                        if (selected[i]) {
-                            if (canRemove(i)) selected[i] = false; // always accept energy-decreasing feasible removal
-                        } else {
-                            if (unif01(rng) < addAcceptProb) selected[i] = true;
-                        }
+// Branch-and-bound prunes per depth over the whole run
+static void print_prunes() {
+    std::lock_guard<std::mutex> lock(g_pruneMutex);
+    long long total = 0;
+    for (long long c : g_prunedPerDepth) total += c;
+    if (total == 0) return;
+    std::cout << "pruned by bound | total=" << total << " | depth:count";
+    for (std::size_t d = 0; d < g_prunedPerDepth.size(); ++d) {
+        if (g_prunedPerDepth[d] > 0) std::cout << " " << d << ":" << g_prunedPerDepth[d];
+    }
+    std::cout << "\n";
+}
 
-                        if (step >= burnIn && ((step - burnIn) % sampleStride == 0)) {
-                            ++sampled;
-                            if (selected[actionIdx]) ++hit;
-                        }
-                    }
+// Breakdown of the run's largest tree and the process peak RSS
+static void print_memory() {
+    std::lock_guard<std::mutex> lock(g_memoryMutex);
+    if (g_largestTree.nodes == 0) return;
+    const MemoryReport& r = g_largestTree;
+    auto mb = [](std::size_t bytes) { return bytes / (1024.0 * 1024.0); };
+    std::cout << std::fixed << std::setprecision(2)
+              << "memory | peak_rss=" << mb(g_peakRssBytes) << "MB | largest tree nodes=" << r.nodes
+              << " bytes/node=" << std::setprecision(1) << r.bytesPerNode() << std::setprecision(2)
+              << " | nodes=" << mb(r.nodeBytes) << "MB bitsets=" << mb(r.bitsetBytes)
+              << "MB hash_sets=" << mb(r.hashSetBytes) << "MB priors=" << mb(r.priorTableBytes)
+              << "MB graph=" << mb(r.graphBytes) << "MB estimator_scratch=" << mb(r.estimatorScratchBytes) << "MB\n";
+}
 
-                    if (sampled > 0) {
-                        prob = static_cast<double>(hit) / static_cast<double>(sampled);
-                    }
-                    prob = std::max(0.01, std::min(0.99, prob));
-                }
-            }
+// Per-phase totals of the run (--stats); phases nest, see stats::Phase
+static void print_stats() {
+    std::lock_guard<std::mutex> lock(g_statsMutex);
+    if (!g_stats.enabled) return;
+    std::cout << "phases | phase calls ms avg_us allocations removed\n";
+    for (int p = 0; p < stats::kNumPhases; ++p) {
+        const stats::PhaseTotals& t = g_stats.phases[p];
+        if (t.calls == 0) continue;
+        std::cout << std::fixed << std::setprecision(3)
+                  << "  " << stats::phaseName(p) << " " << t.calls << " " << t.nanos / 1e6
+                  << " " << t.nanos / 1e3 / t.calls << " " << t.allocations << " " << t.removed << "\n";
+    }
+    if (g_stats.counterMask == 0) return;
+    // Hardware events per completed iteration (unread events print -)
+    const double iters = std::max(1LL, g_stats.iterations);
+    std::cout << "counters | phase ipc";
+    for (int c = 0; c < stats::kNumCounters; ++c) std::cout << " " << stats::counterName(c) << "/it";
+    std::cout << "\n";
+    for (int p = 0; p < stats::kNumPhases; ++p) {
+        const stats::PhaseTotals& t = g_stats.phases[p];
+        if (!stats::countedPhase(p) || t.calls == 0) continue;
+        std::cout << std::fixed << std::setprecision(2) << "  " << stats::phaseName(p) << " ";
+        if (g_stats.hasCounter(stats::Cycles) && g_stats.hasCounter(stats::Instructions) && t.counters[stats::Cycles] > 0) {
+            std::cout << (double)t.counters[stats::Instructions] / (double)t.counters[stats::Cycles];
+        } else {
+            std::cout << "-";
         }
+        std::cout << std::setprecision(0);
+        for (int c = 0; c < stats::kNumCounters; ++c) {
+            if (g_stats.hasCounter(c)) std::cout << " " << t.counters[c] / iters;
+            else std::cout << " -";
+        }
+        std::cout << "\n";
+    }
+}
 
-        return include ? prob : 1 - prob;
-    });
-} */
-
+// Per-depth iterations to convergence of the batch estimator solves
+static void print_convergence(const std::vector<estimator::ConvergenceStats::Row>& rows) {
+    if (rows.empty()) return; // the estimator has no iterative solve
+    auto avg = [](long long total, long long count) { return count > 0 ? (double)total / (double)count : 0.0; };
+    std::cout << "estimator convergence | depth cold_solves cold_avg_it warm_solves warm_avg_it"
+              << " audited_cold_avg_it saved prior_delta\n";
+    for (std::size_t d = 0; d < rows.size(); ++d) {
+        const auto& r = rows[d];
+        if (r.coldSolves + r.warmSolves == 0) continue;
+        std::cout << std::fixed << std::setprecision(1)
+                  << "  " << d << " " << r.coldSolves << " " << avg(r.coldIterations, r.coldSolves)
+                  << " " << r.warmSolves << " " << avg(r.warmIterations, r.warmSolves);
+        if (r.auditedColdIterations > 0) {
+            double audited = avg(r.auditedColdIterations, r.warmSolves);
+            std::cout << " " << audited << " " << 100.0 * (1.0 - avg(r.warmIterations, r.warmSolves) / audited) << "%"
+                      << std::setprecision(3) << " " << r.auditedPriorDelta / (double)r.warmSolves;
+        } else {
+            std::cout << " - - -";
+        }
+        std::cout << "\n";
+    }
+}
 
 int main(int argc, char** argv) {
+    // The topology lists the CPUs of its first caller's mask: read it before any thread is pinned
+    CpuTopology::host();
+
     // Defaults
     std::string manifest = "data/exact/manifest.json"; // default to exact
-    int iterations = 10; // default iterations
-    double explorationParam = 0.0; // default exploration param
+    PerfOptions opts; // iterations, exploration, threads, ...
     std::string outDir = "./result"; // default results folder
+    int jobs = 1; // instances solved concurrently
+    int estimatorThreads = 1; // threads for the perturbation-LP lane blocks
+    std::string estimatorName = "lp"; // global prior estimator
+    bool batchPriors = false; // one estimator solve per residual, shared by descendants
+    double priorRefresh = 0.5; // re-solve when the residual shrinks below this fraction
+    bool convergenceReport = false; // print per-depth estimator iterations (batch priors)
+    std::string unlinkRun; // remove this run's shared incumbents and exit
 
     // Simple CLI parsing
-    // --manifest <path> --iterations <n> --exploration <c> --out-dir <path>
+    // --manifest <path> --iterations <n> --exploration <c> --out-dir <path> --threads <n> --jobs <n> --kernel-threads <n> --estimator-threads <n>
+    // --shared-incumbent <run-id> --unlink-shared-incumbent <run-id> --seed <n> --pin --portfolio <spec> --deadline <seconds> --estimator <name>
+    // --batch-priors --prior-refresh <ratio> --lp-patience <k> --warm-start --audit-warm-start --linear-model <path>
+    // --fixed-budgets --no-prune --exact --sample-ms <ms> --stats --hw-counters
     for (int i = 1; i < argc; ++i) {
         std::string arg = argv[i];
         if (arg == "--manifest" && i + 1 < argc) {
             manifest = argv[++i];
         } else if (arg == "--iterations" && i + 1 < argc) {
-            iterations = std::stoi(argv[++i]);
+            opts.iterations = std::stoi(argv[++i]);
         } else if (arg == "--exploration" && i + 1 < argc) {
-            explorationParam = std::stod(argv[++i]);
+            opts.explorationParam = std::stod(argv[++i]);
         } else if (arg == "--out-dir" && i + 1 < argc) {
             outDir = argv[++i];
+        } else if (arg == "--threads" && i + 1 < argc) {
+            opts.numThreads = std::max(1, std::stoi(argv[++i]));
+        } else if (arg == "--jobs" && i + 1 < argc) {
+            jobs = std::max(1, std::stoi(argv[++i]));
+        } else if (arg == "--kernel-threads" && i + 1 < argc) {
+            opts.kernelThreads = std::max(1, std::stoi(argv[++i]));
+        } else if (arg == "--shared-incumbent" && i + 1 < argc) {
+            opts.sharedIncumbent = argv[++i];
+            if (!SharedIncumbent::validRunId(opts.sharedIncumbent)) {
+                std::cerr << "--shared-incumbent: run id must be 1-64 of [A-Za-z0-9._-]" << std::endl;
+                return 1;
+            }
+        } else if (arg == "--unlink-shared-incumbent" && i + 1 < argc) {
+            unlinkRun = argv[++i];
+            if (!SharedIncumbent::validRunId(unlinkRun)) {
+                std::cerr << "--unlink-shared-incumbent: run id must be 1-64 of [A-Za-z0-9._-]" << std::endl;
+                return 1;
+            }
+        } else if (arg == "--portfolio" && i + 1 < argc) {
+            if (!parse_portfolio(argv[++i], opts.portfolio)) {
+                std::cerr << "Invalid --portfolio spec: " << argv[i] << std::endl;
+                return 1;
+            }
+        } else if (arg == "--estimator" && i + 1 < argc) {
+            estimatorName = argv[++i];
+            if (!estimator_by_name(estimatorName)) {
+                std::cerr << "Unknown --estimator: " << estimatorName << std::endl;
+                return 1;
+            }
+        } else if (arg == "--fixed-budgets") {
+            estimator::perturbationLPConfig.stopping.enabled = false;
+            estimator::gibbsConfig.stopping.enabled = false;
+        } else if (arg == "--linear-model" && i + 1 < argc) {
+            if (!estimator::loadLinearPriorModel(argv[++i], estimator::linearPriorModel)) {
+                std::cerr << "Failed to load linear model: " << argv[i] << std::endl;
+                return 1;
+            }
+        } else if (arg == "--lp-patience" && i + 1 < argc) {
+            estimator::perturbationLPConfig.patience = std::stoi(argv[++i]);
+        } else if (arg == "--warm-start") {
+            estimator::useWarmStarts = true;
+        } else if (arg == "--audit-warm-start") {
+            estimator::useWarmStarts = true;
+            estimator::auditWarmStarts = true;
+        } else if (arg == "--batch-priors") {
+            batchPriors = true;
+        } else if (arg == "--prior-refresh" && i + 1 < argc) {
+            priorRefresh = std::stod(argv[++i]);
+        } else if (arg == "--deadline" && i + 1 < argc) {
+            opts.deadlineSeconds = std::stod(argv[++i]);
+        } else if (arg == "--sample-ms" && i + 1 < argc) {
+            opts.sampleMs = std::max(0.0, std::stod(argv[++i]));
+        } else if (arg == "--stats") {
+            opts.stats = true;
+        } else if (arg == "--hw-counters") {
+            opts.stats = true;
+            opts.hwCounters = true;
+        } else if (arg == "--exact") {
+            opts.exact = true;
+        } else if (arg == "--no-prune") {
+            opts.prune = false;
+        } else if (arg == "--pin") {
+            opts.pin = true;
+        } else if (arg == "--seed" && i + 1 < argc) {
+            opts.seed = std::stoull(argv[++i]);
+        } else if (arg == "--estimator-threads" && i + 1 < argc) {
+            estimatorThreads = std::max(1, std::stoi(argv[++i]));
         }
     }
+    // A portfolio runs one thread per member; its trees are not tree-parallel
+    if (!opts.portfolio.empty() && opts.numThreads > 1) {
+        std::cerr << "--portfolio runs one thread per member and does not take --threads" << std::endl;
+        return 1;
+    }
 
     // Load items (timed)
     auto tManStart = std::chrono::steady_clock::now();
@@ -526,6 +1081,14 @@ int main(int argc, char** argv) {
     std::cout << std::fixed << std::setprecision(3)
               << "Loaded " << items.size() << " instances from manifest in " << manifestSecs << "s\n";
 
+    // End of a --shared-incumbent run: remove its segments instead of solving
+    if (!unlinkRun.empty()) {
+        int removed = 0;
+        for (const auto& item : items) removed += SharedIncumbent::unlink(loadGraphFromJson(item.input), unlinkRun);
+        std::cout << "Removed " << removed << " shared incumbents of run " << unlinkRun << "\n";
+        return 0;
+    }
+
     // Ensure output directory exists
     std::error_code ec;
     std::filesystem::create_directories(outDir, ec);
@@ -544,7 +1107,11 @@ int main(int argc, char** argv) {
 
     // Compose output filename
     std::ostringstream fname;
-    fname << outDir << "/mvc_" << tag << "_iters-" << iterations << "_exp-" << explorationParam << ".csv";
+    fname << outDir << "/mvc_" << tag << "_iters-" << opts.iterations << "_exp-" << opts.explorationParam;
+    if (opts.numThreads > 1) fname << "_threads-" << opts.numThreads;
+    if (!opts.portfolio.empty()) fname << "_portfolio-" << opts.portfolio.size();
+    if (opts.exact) fname << "_exact";
+    fname << ".csv";
     std::string outPath = fname.str();
 
     std::ofstream out(outPath);
@@ -553,15 +1120,77 @@ int main(int argc, char** argv) {
         return 1;
     }
 
+    // Anytime trace of tree searches next to the results: <name>_trace.csv
+    std::unique_ptr<std::ofstream> trace;
+    if (opts.sampleMs > 0.0 && !opts.exact && opts.portfolio.empty()) {
+        std::string tracePath = outPath.substr(0, outPath.size() - 4) + "_trace.csv";
+        trace = std::make_unique<std::ofstream>(tracePath);
+        if (!*trace) {
+            std::cerr << "Failed to open trace file: " << tracePath << std::endl;
+            return 1;
+        }
+    }
+
+    // Per-phase search stats next to the results: <name>_stats.csv
+    std::unique_ptr<std::ofstream> statsOut;
+#ifndef MCTS_STATS
+    if (opts.stats) {
+        std::cerr << "--stats: built without -DMCTS_STATS, no stats are recorded" << std::endl;
+        opts.stats = false;
+    }
+#else
+    if (opts.hwCounters) {
+        // Probed on this thread; search threads open their own counters on first use
+        const unsigned mask = stats::enableHardwareCounters(true);
+        std::cout << "hw counters |";
+        if (mask == 0) std::cout << " unavailable (perf_event_open failed), wall time only";
+        for (int c = 0; c < stats::kNumCounters; ++c) {
+            if (mask & (1u << c)) std::cout << " " << stats::counterName(c);
+        }
+        std::cout << "\n";
+    }
+#endif
+    if (opts.stats && !opts.exact) {
+        std::string statsPath = outPath.substr(0, outPath.size() - 4) + "_stats.csv";
+        statsOut = std::make_unique<std::ofstream>(statsPath);
+        if (!*statsOut) {
+            std::cerr << "Failed to open stats file: " << statsPath << std::endl;
+            return 1;
+        }
+    }
+
     // Info
     std::cout << "Writing results to: " << outPath << std::endl;
     
     // Run perf and write CSV (timed per instance internally)
     init_estimate_policy();
-    double runSecs = run_perf(items, iterations, explorationParam, out);
+    if (estimatorName != "lp") treePolicy::setEstimatePolicy(estimator_by_name(estimatorName));
+    if (batchPriors) {
+        treePolicy::BatchEstimatePolicy batch = batch_estimator_by_name(estimatorName);
+        if (!batch) {
+            std::cerr << "--batch-priors: no batch version of estimator " << estimatorName << std::endl;
+            return 1;
+        }
+        treePolicy::setBatchEstimatePolicy(batch, priorRefresh);
+        convergenceReport = true;
+    }
+    std::unique_ptr<WorkStealingPool> estimatorPool;
+    if (estimatorThreads > 1) {
+        estimatorPool = std::make_unique<WorkStealingPool>(estimatorThreads, opts.pin ? Placement::Compact : Placement::None);
+        estimator::perturbationLPConfig.pool = estimatorPool.get();
+    }
+    double runSecs = jobs > 1
+        ? run_perf_jobs(items, opts, jobs, out, trace.get(), statsOut.get())
+        : run_perf(items, opts, out, trace.get(), statsOut.get());
     std::cout << std::fixed << std::setprecision(3)
               << "Total time | manifest=" << manifestSecs << "s"
               << " run=" << runSecs << "s"
               << " | overall=" << (manifestSecs + runSecs) << "s\n";
+    print_rule3();
+    print_prunes();
+    print_stats();
+    print_memory();
+    if (convergenceReport) print_convergence(estimator::convergenceStats.rows());
+    print_budgets(estimator::budgetStats.rows());
     return 0;
 }
\ No newline at end of file
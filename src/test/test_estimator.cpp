@@ -1,380 +1,701 @@
-#include <iostream>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
 #include <iomanip>
+#include <iostream>
+#include <limits>
+#include <new>
+#include <regex>
+#include <sstream>
 #include <string>
+#include <memory>
 #include <vector>
-#include <cmath>
-#include <algorithm>
-#include <limits>
-#include <unordered_set>
-#include <cstdint>
-#include <random>
-#include <queue>
 
+#include "../lib/crown.hpp"
+#include "../lib/estimator.hpp"
+#include "../lib/parallel.hpp"
 #include "../lib/utils.hpp"
 
-static std::vector<std::pair<int, int>> build_edges(const Graph& graph,
-                                                    const std::unordered_set<int>* activeSet = nullptr) {
-    std::vector<std::pair<int, int>> edges;
-    for (int u = 0; u < graph.numVertices; ++u) {
-        if (activeSet && !activeSet->count(u)) continue;
-        for (int v : graph.adjacencyList[u]) {
-            if (activeSet && !activeSet->count(v)) continue;
-            if (u < v) edges.push_back({u, v});
-        }
-    }
-    return edges;
-}
+// Counts every global allocation; the benchmark reads it around estimator calls.
+static std::atomic<long long> g_allocations(0);
 
-static bool all_edges_covered(const std::vector<std::pair<int, int>>& edges,
-                              const std::vector<bool>& selected) {
-    for (const auto& e : edges) {
-        if (!selected[e.first] && !selected[e.second]) return false;
-    }
-    return true;
+// Out of line so GCC does not pair the inlined malloc()/free() with new/delete-expressions
+__attribute__((noinline)) void* operator new(std::size_t size) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
 }
 
-static int selected_count(const std::vector<bool>& selected) {
-    int c = 0;
-    for (bool b : selected) if (b) ++c;
-    return c;
+__attribute__((noinline)) void operator delete(void* p) noexcept { std::free(p); }
+__attribute__((noinline)) void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+static std::vector<std::string> load_manifest_inputs(const std::string& path) {
+    std::ifstream in(path);
+    if (!in) { std::cerr << "Failed to open manifest: " << path << std::endl; std::exit(1); }
+    std::ostringstream ss; ss << in.rdbuf();
+    std::string s = ss.str();
+    std::regex reInput("\\\"input\\\"\\s*:\\s*\\\"([^\\\"]+)\\\"");
+    std::vector<std::string> inputs;
+    for (std::sregex_iterator it(s.begin(), s.end(), reInput), end; it != end; ++it) inputs.push_back((*it)[1]);
+    return inputs;
 }
 
-static int first_uncovered_edge_index(const std::vector<std::pair<int, int>>& edges,
-                                      const std::vector<bool>& selected) {
-    for (int i = 0; i < static_cast<int>(edges.size()); ++i) {
-        const auto& e = edges[i];
-        if (!selected[e.first] && !selected[e.second]) return i;
+// Crown (Nemhauser-Trotter) fixpoint, as the MCTS root reduction does it
+static void apply_crown_decomposition(State& state, const Graph& graph) {
+    while (!state.possibleVertices.empty()) {
+        NemhauserTrotter nt(graph.numVertices, graph.adjacencyList, state.possibleVertices);
+        std::vector<int> toInclude, toExclude;
+        nt.getKernelNodes(toInclude, toExclude);
+        if (toInclude.empty() && toExclude.empty()) {
+            state.lpBound = nt.lpBound();
+            break;
+        }
+        for (int u : toInclude) state.include(u);
+        for (int u : toExclude) state.exclude(u);
     }
-    return -1;
 }
 
-static uint64_t to_mask_u64(const std::vector<bool>& selected) {
-    uint64_t mask = 0ULL;
-    for (int i = 0; i < static_cast<int>(selected.size()); ++i) {
-        if (selected[i]) mask |= (1ULL << i);
-    }
-    return mask;
-}
+// Exact minimum-cover counting on the crown core (up to kMaxCore vertices as bitsets)
+namespace {
+    constexpr int kWords = 2;
+    constexpr int kMaxCore = 64 * kWords;
+    constexpr int kSplitDepth = 6;   // branches above this depth run as parallel tasks
+
+    struct Bits {
+        std::uint64_t w[kWords] = {};
+
+        void set(int i) { w[i >> 6] |= 1ULL << (i & 63); }
+        void reset(int i) { w[i >> 6] &= ~(1ULL << (i & 63)); }
+        bool test(int i) const { return (w[i >> 6] >> (i & 63)) & 1ULL; }
+        bool any() const {
+            for (int k = 0; k < kWords; ++k) if (w[k]) return true;
+            return false;
+        }
+        int count() const {
+            int c = 0;
+            for (int k = 0; k < kWords; ++k) c += __builtin_popcountll(w[k]);
+            return c;
+        }
+        Bits operator&(const Bits& o) const { Bits r; for (int k = 0; k < kWords; ++k) r.w[k] = w[k] & o.w[k]; return r; }
+        Bits operator|(const Bits& o) const { Bits r; for (int k = 0; k < kWords; ++k) r.w[k] = w[k] | o.w[k]; return r; }
+        Bits without(const Bits& o) const { Bits r; for (int k = 0; k < kWords; ++k) r.w[k] = w[k] & ~o.w[k]; return r; }
+
+        template <typename F>
+        void forEach(F&& f) const {
+            for (int k = 0; k < kWords; ++k) {
+                for (std::uint64_t x = w[k]; x; x &= x - 1) f(64 * k + __builtin_ctzll(x));
+            }
+        }
+    };
 
-static void enumerate_all_mvc_bruteforce(const Graph& graph,
-                                         const std::unordered_set<int>& activeSet,
-                                         long long& totalMvcCount,
-                                         std::vector<long long>& vertexInMvcCount,
-                                         int& mvcSize) {
-    totalMvcCount = 0;
-    vertexInMvcCount.assign(graph.numVertices, 0);
-    mvcSize = -1;
-
-    if (activeSet.size() > 20) {
-        return; // bitmask 기반 브루트포스 한계
-    }
+    // Minimum cover size of a residual and how many minimum covers contain each vertex.
+    // Counts are doubles (exact below 2^53 covers).
+    struct CoverCount {
+        int opt = std::numeric_limits<int>::max();  // max() => no cover within the limit
+        double count = 0.0;
+        std::vector<double> incl;                   // per core index
+    };
 
-    const auto edges = build_edges(graph, &activeSet);
-    std::vector<bool> selected(graph.numVertices, false);
-    int bestSize = std::numeric_limits<int>::max();
-    std::unordered_set<uint64_t> bestMasks;
+    class MvcCounter {
+    public:
+        MvcCounter(std::vector<Bits> adj, WorkStealingPool* pool) : adj(std::move(adj)), pool(pool) {}
 
-    std::function<void()> dfs = [&]() {
-        int curSize = selected_count(selected);
-        if (curSize > bestSize) return;
+        // With the limit set to the optimum, every sub-limit is tight as well, so the parallel
+        // branches prune exactly like the sequential ones.
+        CoverCount solve(const Bits& residual) {
+            int opt = optimum(residual, residual.count());
+            return solve(residual, opt, 0);
+        }
 
-        int uncoveredIdx = first_uncovered_edge_index(edges, selected);
-        if (uncoveredIdx == -1) {
-            if (curSize < bestSize) {
-                bestSize = curSize;
-                bestMasks.clear();
+    private:
+        // Greedy maximal matching: a lower bound on any cover of the residual
+        int matchingBound(const Bits& residual) const {
+            Bits free = residual;
+            int matched = 0;
+            residual.forEach([&](int u) {
+                if (!free.test(u)) return;
+                Bits nb = adj[u] & free;
+                if (!nb.any()) return;
+                nb.forEach([&](int v) {
+                    if (!free.test(u)) return;
+                    free.reset(u);
+                    free.reset(v);
+                    ++matched;
+                });
+            });
+            return matched;
+        }
+
+        // Connected component of residual containing start
+        Bits component(const Bits& residual, int start) const {
+            Bits seen, frontier;
+            seen.set(start);
+            frontier.set(start);
+            while (frontier.any()) {
+                Bits next;
+                frontier.forEach([&](int u) { next = next | adj[u]; });
+                next = (next & residual).without(seen);
+                seen = seen | next;
+                frontier = next;
             }
-            if (curSize == bestSize) {
-                bestMasks.insert(to_mask_u64(selected));
+            return seen;
+        }
+
+        // Removes isolated vertices and moves vertices of degree > limit into forced.
+        // Returns false if more than limit vertices are forced.
+        bool reduce(Bits& residual, int limit, std::vector<int>& forced) const {
+            for (bool changed = true; changed;) {
+                changed = false;
+                Bits next = residual;
+                residual.forEach([&](int u) {
+                    int deg = (adj[u] & next).count();
+                    if (deg == 0) {
+                        next.reset(u);
+                    } else if (deg > limit - static_cast<int>(forced.size())) {
+                        next.reset(u);
+                        forced.push_back(u);
+                        changed = true;
+                    }
+                });
+                residual = next;
+                if (static_cast<int>(forced.size()) > limit) return false;
             }
-            return;
+            return true;
         }
 
-        const auto [u, v] = edges[uncoveredIdx];
+        int maxDegreeVertex(const Bits& residual) const {
+            int v = -1, best = -1;
+            residual.forEach([&](int u) {
+                int deg = (adj[u] & residual).count();
+                if (deg > best) { best = deg; v = u; }
+            });
+            return v;
+        }
 
-        selected[u] = true;
-        dfs();
-        selected[u] = false;
+        // Minimum cover size (one optimum, strict pruning), or max() if it exceeds limit
+        int optimum(Bits residual, int limit) const {
+            const int none = std::numeric_limits<int>::max();
+            std::vector<int> forced;
+            if (!reduce(residual, limit, forced)) return none;
+            const int budget = limit - static_cast<int>(forced.size());
+            if (!residual.any()) return static_cast<int>(forced.size());
+            if (matchingBound(residual) > budget) return none;
+
+            const int v = maxDegreeVertex(residual);
+            Bits withoutV = residual;
+            withoutV.reset(v);
+            const Bits nbrs = adj[v] & residual;
+            const int numNbrs = nbrs.count();
+            int best = optimum(withoutV, budget - 1);
+            if (best != none) best += 1;
+            const int skipLimit = std::min(budget, best == none ? budget : best - 1);
+            if (skipLimit >= numNbrs) {
+                int skip = optimum(withoutV.without(nbrs), skipLimit - numNbrs);
+                if (skip != none) best = std::min(best, skip + numNbrs);
+            }
+            return best == none ? none : best + static_cast<int>(forced.size());
+        }
 
-        selected[v] = true;
-        dfs();
-        selected[v] = false;
-    };
+        CoverCount emptyResult(int opt) const {
+            CoverCount r;
+            r.opt = opt;
+            r.count = 1.0;
+            r.incl.assign(adj.size(), 0.0);
+            return r;
+        }
 
-    dfs();
+        // All minimum covers of residual, or opt = max() if every cover exceeds limit.
+        // Reductions keep every optimum: isolated vertices are in no minimum cover, a vertex of
+        // degree > limit is in every cover within the limit, and components multiply.
+        CoverCount solve(Bits residual, int limit, int depth) {
+            const CoverCount none;
+            std::vector<int> forced;
+            if (!reduce(residual, limit, forced)) return none;
+            const int budget = limit - static_cast<int>(forced.size());
+
+            CoverCount result;
+            if (!residual.any()) {
+                result = emptyResult(0);
+            } else if (matchingBound(residual) > budget) {
+                return none;
+            } else {
+                int first = -1;
+                residual.forEach([&](int u) { if (first < 0) first = u; });
+                Bits comp = component(residual, first);
+                if (comp.count() < residual.count()) {
+                    result = solveComponents(residual, budget, depth);
+                } else {
+                    result = branch(residual, budget, depth);
+                }
+                if (result.opt == none.opt) return none;
+            }
 
-    if (bestSize == std::numeric_limits<int>::max()) {
-        mvcSize = 0;
-        totalMvcCount = 1;
-        return;
-    }
+            result.opt += static_cast<int>(forced.size());
+            for (int u : forced) result.incl[u] += result.count;
+            return result;
+        }
 
-    mvcSize = bestSize;
-    totalMvcCount = static_cast<long long>(bestMasks.size());
-    for (uint64_t mask : bestMasks) {
-        for (int v = 0; v < graph.numVertices; ++v) {
-            if (mask & (1ULL << v)) {
-                vertexInMvcCount[v]++;
+        CoverCount solveComponents(Bits residual, int budget, int depth) {
+            std::vector<Bits> comps;
+            std::vector<int> bounds;
+            int boundSum = 0;
+            while (residual.any()) {
+                int first = -1;
+                residual.forEach([&](int u) { if (first < 0) first = u; });
+                comps.push_back(component(residual, first));
+                residual = residual.without(comps.back());
+                bounds.push_back(matchingBound(comps.back()));
+                boundSum += bounds.back();
+            }
+            if (boundSum > budget) return CoverCount();
+
+            std::vector<CoverCount> parts(comps.size());
+            int slack = budget - boundSum;
+            for (std::size_t c = 0; c < comps.size(); ++c) {
+                parts[c] = solve(comps[c], bounds[c] + slack, depth);
+                if (parts[c].opt == CoverCount().opt) return CoverCount();
+                slack -= parts[c].opt - bounds[c];
             }
-        }
-    }
-}
 
-// Keep this in sync with current estimatePolicy used in perf_mcts.cpp
-static void init_estimate_policy() {
-	treePolicy::setEstimatePolicy([](const State& state, const Graph& graph, bool include) {
-        // Strategy #8 (Dual-based probability):
-        // Approximate LP-dual edge packing y_e with constraints
-        //   sum_{e incident v} y_e <= 1, y_e >= 0
-        // and set p_v proportional to incident dual mass:
-        //   p_v ∝ sum_{e incident v} y_e.
-        double prob = 0.5;
-
-        const int v = state.actionVertex;
-        if (v >= 0 && v < graph.numVertices && state.possibleVertices.count(v)) {
-            // Active core indexing
-            std::vector<int> activeVerts;
-            activeVerts.reserve(state.possibleVertices.size());
-            std::vector<int> idxOf(graph.numVertices, -1);
-            for (int u : state.possibleVertices) {
-                idxOf[u] = static_cast<int>(activeVerts.size());
-                activeVerts.push_back(u);
+            CoverCount result = emptyResult(0);
+            for (const CoverCount& part : parts) {
+                result.opt += part.opt;
+                result.count *= part.count;
             }
+            for (std::size_t c = 0; c < comps.size(); ++c) {
+                const double others = result.count / parts[c].count;
+                comps[c].forEach([&](int u) { result.incl[u] = parts[c].incl[u] * others; });
+            }
+            return result;
+        }
 
-            const int n = static_cast<int>(activeVerts.size());
-            const int actionIdx = idxOf[v];
-            if (n > 0 && actionIdx >= 0) {
-                // Build active edge list (local indices)
-                std::vector<std::pair<int, int>> edges;
-                for (int ug : activeVerts) {
-                    int u = idxOf[ug];
-                    for (int vg : graph.adjacencyList[ug]) {
-                        int w = (vg >= 0 && vg < graph.numVertices) ? idxOf[vg] : -1;
-                        if (w >= 0 && u < w) edges.push_back({u, w});
-                    }
-                }
+        // v in the cover, or N(v) in the cover: the two branches partition the covers
+        CoverCount branch(const Bits& residual, int budget, int depth) {
+            const int v = maxDegreeVertex(residual);
+            Bits withoutV = residual;
+            withoutV.reset(v);
+            const Bits nbrs = adj[v] & residual;
+            const Bits withoutClosed = withoutV.without(nbrs);
+            const int numNbrs = nbrs.count();
+
+            CoverCount take, skip;
+            if (pool && pool->size() > 1 && depth < kSplitDepth) {
+                pool->parallelFor(0, 2, 1, [&](int lo, int) {
+                    if (lo == 0) take = solve(withoutV, budget - 1, depth + 1);
+                    else if (budget >= numNbrs) skip = solve(withoutClosed, budget - numNbrs, depth + 1);
+                });
+            } else {
+                take = solve(withoutV, budget - 1, depth + 1);
+                // Ties with the take branch still count, so the bound is <= rather than <
+                int skipLimit = budget;
+                if (take.opt != CoverCount().opt) skipLimit = std::min(skipLimit, take.opt + 1);
+                if (skipLimit >= numNbrs) skip = solve(withoutClosed, skipLimit - numNbrs, depth + 1);
+            }
 
-                if (edges.empty()) {
-                    prob = 0.01; // no edge pressure => typically excluded
-                } else {
-                    // Greedy dual packing approximation
-                    std::vector<double> rem(n, 1.0);     // remaining dual capacity per vertex
-                    std::vector<double> load(n, 0.0);    // sum incident y_e per vertex
-
-                    // Multiple light passes to reduce order bias
-                    constexpr int kPasses = 3;
-                    for (int pass = 0; pass < kPasses; ++pass) {
-                        for (const auto& e : edges) {
-                            int a = e.first;
-                            int b = e.second;
-                            if (rem[a] <= 1e-12 || rem[b] <= 1e-12) continue;
-
-                            // Add only a fraction to share capacity across edges
-                            double delta = 0.5 * std::min(rem[a], rem[b]);
-                            if (delta <= 1e-12) continue;
-
-                            rem[a] -= delta;
-                            rem[b] -= delta;
-                            load[a] += delta;
-                            load[b] += delta;
-                        }
-                    }
+            const int none = CoverCount().opt;
+            const int takeOpt = take.opt == none ? none : take.opt + 1;
+            const int skipOpt = skip.opt == none ? none : skip.opt + numNbrs;
+            const int opt = std::min(takeOpt, skipOpt);
+            if (opt == none) return CoverCount();
+
+            CoverCount result = emptyResult(opt);
+            result.count = 0.0;
+            if (takeOpt == opt) {
+                result.count += take.count;
+                for (std::size_t i = 0; i < adj.size(); ++i) result.incl[i] += take.incl[i];
+                result.incl[v] += take.count;
+            }
+            if (skipOpt == opt) {
+                result.count += skip.count;
+                for (std::size_t i = 0; i < adj.size(); ++i) result.incl[i] += skip.incl[i];
+                nbrs.forEach([&](int u) { result.incl[u] += skip.count; });
+            }
+            return result;
+        }
 
-                    // p_v proportional to incident dual mass
-                    double maxLoad = 0.0;
-                    for (double x : load) maxLoad = std::max(maxLoad, x);
-                    if (maxLoad > 1e-12) {
-                        prob = load[actionIdx] / maxLoad;
-                    } else {
-                        prob = 0.5;
-                    }
+        std::vector<Bits> adj;
+        WorkStealingPool* pool;
+    };
+}
 
-                    prob = std::max(0.01, std::min(0.99, prob));
-                }
-            }
+// Counts all minimum vertex covers of the core with MvcCounter.
+// frequency[i] receives the fraction of minimum covers containing core[i].
+static bool exact_inclusion_frequencies(const Graph& graph, const std::vector<int>& core, WorkStealingPool* pool,
+                                        std::vector<double>& frequency, int& mvcSize, double& mvcCount) {
+    const int n = static_cast<int>(core.size());
+    if (n > kMaxCore) return false;
+    std::vector<int> idxOf(graph.numVertices, -1);
+    for (int i = 0; i < n; ++i) idxOf[core[i]] = i;
+    std::vector<Bits> adj(n);
+    Bits all;
+    for (int i = 0; i < n; ++i) {
+        all.set(i);
+        for (int w : graph.adjacencyList[core[i]]) {
+            if (idxOf[w] >= 0) adj[i].set(idxOf[w]);
         }
+    }
 
-        return include ? prob : 1 - prob;
-    });
+    CoverCount result = MvcCounter(std::move(adj), pool).solve(all);
+    mvcSize = result.opt;
+    mvcCount = result.count;
+    frequency.resize(n);
+    for (int i = 0; i < n; ++i) frequency[i] = result.incl[i] / result.count;
+    return true;
 }
 
-namespace {
-class NemhauserTrotter {
-    int n;
-    const std::vector<std::vector<int>>& adj;
-    const std::unordered_set<int>& possible;
-    std::vector<int> pairU;
-    std::vector<int> pairV;
-    std::vector<int> dist;
-
-public:
-    NemhauserTrotter(int n,
-                     const std::vector<std::vector<int>>& adj,
-                     const std::unordered_set<int>& possible)
-        : n(n), adj(adj), possible(possible), pairU(n, -1), pairV(n, -1), dist(n, 0) {}
-
-    bool bfs() {
-        std::queue<int> q;
-        int distNIL = std::numeric_limits<int>::max();
-        for (int u = 0; u < n; ++u) {
-            if (!possible.count(u)) continue;
-            if (pairU[u] == -1) {
-                dist[u] = 0;
-                q.push(u);
-            } else {
-                dist[u] = std::numeric_limits<int>::max();
+// Average ranks (ties share the mean rank)
+static std::vector<double> ranks(const std::vector<double>& values) {
+    std::vector<int> order(values.size());
+    for (std::size_t i = 0; i < order.size(); ++i) order[i] = static_cast<int>(i);
+    std::sort(order.begin(), order.end(), [&](int a, int b) { return values[a] < values[b]; });
+    std::vector<double> r(values.size());
+    for (std::size_t i = 0; i < order.size();) {
+        std::size_t j = i;
+        while (j + 1 < order.size() && values[order[j + 1]] == values[order[i]]) ++j;
+        for (std::size_t k = i; k <= j; ++k) r[order[k]] = 0.5 * static_cast<double>(i + j);
+        i = j + 1;
+    }
+    return r;
+}
+
+// Spearman correlation; NaN when either side is constant
+static double spearman(const std::vector<double>& a, const std::vector<double>& b) {
+    std::vector<double> ra = ranks(a), rb = ranks(b);
+    const double n = static_cast<double>(a.size());
+    double ma = 0.0, mb = 0.0;
+    for (std::size_t i = 0; i < ra.size(); ++i) { ma += ra[i]; mb += rb[i]; }
+    ma /= n; mb /= n;
+    double cov = 0.0, va = 0.0, vb = 0.0;
+    for (std::size_t i = 0; i < ra.size(); ++i) {
+        cov += (ra[i] - ma) * (rb[i] - mb);
+        va += (ra[i] - ma) * (ra[i] - ma);
+        vb += (rb[i] - mb) * (rb[i] - mb);
+    }
+    if (va <= 0.0 || vb <= 0.0) return std::numeric_limits<double>::quiet_NaN();
+    return cov / std::sqrt(va * vb);
+}
+
+// One benchmarked estimator (a registry entry in per-vertex or batch mode)
+struct Candidate {
+    std::string label;
+    treePolicy::EstimatePolicy perVertex;
+    treePolicy::BatchEstimatePolicy batch;
+};
+
+struct Score {
+    int instances = 0;
+    long long vertices = 0;
+    double brierSum = 0.0;
+    double spearmanSum = 0.0;
+    int spearmanInstances = 0;
+    long long calls = 0;
+    long long priors = 0;
+    double seconds = 0.0;
+    long long allocations = 0;
+    std::vector<long long> binCount;
+    std::vector<double> binProb, binFreq;
+};
+
+// Priors of the core vertices; adds time, calls and allocations of `repeat` evaluations to score
+static std::vector<double> evaluate(const Candidate& candidate, State& state, const Graph& graph,
+                                    const std::vector<int>& core, int repeat, Score& score) {
+    std::vector<double> p(core.size(), 0.5);
+    std::vector<double> table(graph.numVertices, 0.5), warmStart;
+    for (int r = 0; r < repeat; ++r) {
+        auto t0 = std::chrono::steady_clock::now();
+        long long a0 = g_allocations.load(std::memory_order_relaxed);
+        if (candidate.batch) {
+            candidate.batch(state, graph, table, warmStart);
+            ++score.calls;
+        } else {
+            for (std::size_t i = 0; i < core.size(); ++i) {
+                state.actionVertex = core[i];
+                p[i] = candidate.perVertex(state, graph, true);
             }
+            score.calls += static_cast<long long>(core.size());
         }
+        score.allocations += g_allocations.load(std::memory_order_relaxed) - a0;
+        score.seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+        score.priors += static_cast<long long>(core.size());
+    }
+    if (candidate.batch) {
+        for (std::size_t i = 0; i < core.size(); ++i) p[i] = table[core[i]];
+    }
+    return p;
+}
 
-        while (!q.empty()) {
-            int u = q.front();
-            q.pop();
-            if (dist[u] < distNIL) {
-                for (int v : adj[u]) {
-                    if (!possible.count(v)) continue;
-                    if (pairV[v] == -1) {
-                        if (distNIL == std::numeric_limits<int>::max()) {
-                            distNIL = dist[u] + 1;
-                        }
-                    } else if (dist[pairV[v]] == std::numeric_limits<int>::max()) {
-                        dist[pairV[v]] = dist[u] + 1;
-                        q.push(pairV[v]);
-                    }
-                }
-            }
+// Fits the linear prior by Newton's method on the logistic loss with soft labels (exact
+// inclusion frequencies). Features that are constant over the training set keep weight 0.
+static estimator::LinearPriorModel fit_linear_prior(const std::vector<double>& features,
+                                                    const std::vector<double>& labels) {
+    constexpr int kDim = estimator::kLinearFeatures + 1;
+    constexpr double kRidge = 1e-6;
+    const std::size_t rows = labels.size();
+    std::vector<bool> used(kDim, true);
+    for (int k = 0; k < estimator::kLinearFeatures; ++k) {
+        double lo = std::numeric_limits<double>::max(), hi = std::numeric_limits<double>::lowest();
+        for (std::size_t i = 0; i < rows; ++i) {
+            lo = std::min(lo, features[i * estimator::kLinearFeatures + k]);
+            hi = std::max(hi, features[i * estimator::kLinearFeatures + k]);
         }
-        return distNIL != std::numeric_limits<int>::max();
+        used[k + 1] = hi - lo > 1e-12;
     }
 
-    bool dfs(int u) {
-        if (u != -1) {
-            for (int v : adj[u]) {
-                if (!possible.count(v)) continue;
-                if (pairV[v] == -1 || (dist[pairV[v]] == dist[u] + 1 && dfs(pairV[v]))) {
-                    pairV[v] = u;
-                    pairU[u] = v;
-                    return true;
-                }
+    estimator::LinearPriorModel model;
+    model.weights.fill(0.0);
+    for (int iter = 0; iter < 50; ++iter) {
+        double grad[kDim] = {};
+        double hess[kDim][kDim] = {};
+        for (std::size_t i = 0; i < rows; ++i) {
+            double row[kDim] = {1.0};
+            for (int k = 0; k < estimator::kLinearFeatures; ++k) row[k + 1] = features[i * estimator::kLinearFeatures + k];
+            double z = 0.0;
+            for (int a = 0; a < kDim; ++a) z += model.weights[a] * row[a];
+            const double p = 1.0 / (1.0 + std::exp(-z));
+            for (int a = 0; a < kDim; ++a) {
+                grad[a] += (p - labels[i]) * row[a];
+                for (int b = 0; b < kDim; ++b) hess[a][b] += p * (1.0 - p) * row[a] * row[b];
             }
-            dist[u] = std::numeric_limits<int>::max();
-            return false;
         }
-        return true;
+        // Unused features: identity rows, zero gradient
+        for (int a = 0; a < kDim; ++a) {
+            hess[a][a] += kRidge * static_cast<double>(rows);
+            if (used[a]) continue;
+            grad[a] = 0.0;
+            for (int b = 0; b < kDim; ++b) hess[a][b] = hess[b][a] = 0.0;
+            hess[a][a] = 1.0;
+        }
+        // Solve hess * step = grad (Gaussian elimination, partial pivoting)
+        double step[kDim];
+        for (int col = 0; col < kDim; ++col) {
+            int pivot = col;
+            for (int r = col + 1; r < kDim; ++r) {
+                if (std::fabs(hess[r][col]) > std::fabs(hess[pivot][col])) pivot = r;
+            }
+            std::swap(hess[col], hess[pivot]);
+            std::swap(grad[col], grad[pivot]);
+            for (int r = col + 1; r < kDim; ++r) {
+                const double f = hess[r][col] / hess[col][col];
+                for (int c = col; c < kDim; ++c) hess[r][c] -= f * hess[col][c];
+                grad[r] -= f * grad[col];
+            }
+        }
+        double norm = 0.0;
+        for (int col = kDim - 1; col >= 0; --col) {
+            double v = grad[col];
+            for (int c = col + 1; c < kDim; ++c) v -= hess[col][c] * step[c];
+            step[col] = v / hess[col][col];
+            model.weights[col] -= step[col];
+            norm = std::max(norm, std::fabs(step[col]));
+        }
+        if (norm < 1e-10) break;
     }
+    return model;
+}
 
-    void computeMaxMatching() {
-        while (bfs()) {
-            for (int u = 0; u < n; ++u) {
-                if (possible.count(u) && pairU[u] == -1) dfs(u);
+int main(int argc, char** argv) {
+    // Estimator quality-vs-cost benchmark over manifests (or single graphs).
+    // --manifest <path> (repeatable) --estimators <a,b,...> --max-core <n> --threads <n> --repeat <n> --bins <n> --csv <path>
+    // --train <model-out> (fit the linear prior instead of benchmarking) --linear-model <path> --fixed-budgets
+    // positional arguments are graph files; the default is data/exact/manifest.json
+    std::vector<std::string> inputs;
+    std::vector<std::string> names;
+    int maxCore = 100;
+    int threads = 1;
+    int repeat = 3;
+    int bins = 10;
+    std::string csvPath;
+    std::string trainPath;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--manifest" && i + 1 < argc) {
+            std::vector<std::string> items = load_manifest_inputs(argv[++i]);
+            inputs.insert(inputs.end(), items.begin(), items.end());
+        } else if (arg == "--estimators" && i + 1 < argc) {
+            std::stringstream list(argv[++i]);
+            std::string name;
+            while (std::getline(list, name, ',')) names.push_back(name);
+        } else if (arg == "--max-core" && i + 1 < argc) {
+            maxCore = std::min(kMaxCore, std::stoi(argv[++i]));
+        } else if (arg == "--threads" && i + 1 < argc) {
+            threads = std::max(1, std::stoi(argv[++i]));
+        } else if (arg == "--repeat" && i + 1 < argc) {
+            repeat = std::max(1, std::stoi(argv[++i]));
+        } else if (arg == "--bins" && i + 1 < argc) {
+            bins = std::max(1, std::stoi(argv[++i]));
+        } else if (arg == "--csv" && i + 1 < argc) {
+            csvPath = argv[++i];
+        } else if (arg == "--fixed-budgets") {
+            estimator::perturbationLPConfig.stopping.enabled = false;
+            estimator::gibbsConfig.stopping.enabled = false;
+        } else if (arg == "--train" && i + 1 < argc) {
+            trainPath = argv[++i];
+        } else if (arg == "--linear-model" && i + 1 < argc) {
+            if (!estimator::loadLinearPriorModel(argv[++i], estimator::linearPriorModel)) {
+                std::cerr << "Failed to load linear model: " << argv[i] << std::endl;
+                return 1;
             }
+        } else if (!arg.empty() && arg[0] != '-') {
+            inputs.push_back(arg);
+        } else {
+            std::cerr << "Unknown argument: " << arg << std::endl;
+            return 1;
         }
     }
+    if (inputs.empty()) inputs = load_manifest_inputs("data/exact/manifest.json");
+
+    // Every registered estimator, and the batch version of those that have one
+    std::vector<Candidate> candidates;
+    for (const estimator::Registered& entry : estimator::registry()) {
+        if (!names.empty() && std::find(names.begin(), names.end(), entry.name) == names.end()) continue;
+        candidates.push_back({entry.name, entry.perVertex, {}});
+        if (entry.batch) candidates.push_back({entry.name + "[batch]", {}, entry.batch});
+    }
+    for (const std::string& name : names) {
+        if (!estimator::find(name)) { std::cerr << "Unknown estimator: " << name << std::endl; return 1; }
+    }
 
-    void getKernelNodes(std::vector<int>& toInclude, std::vector<int>& toExclude) {
-        computeMaxMatching();
+    std::ofstream csv;
+    if (!csvPath.empty()) {
+        csv.open(csvPath);
+        csv << "instance,vertex,estimator,prob_include,mvc_inclusion_freq\n";
+    }
 
-        std::vector<bool> ZL(n, false), ZR(n, false);
-        std::queue<int> q;
-        for (int u = 0; u < n; ++u) {
-            if (possible.count(u) && pairU[u] == -1) {
-                ZL[u] = true;
-                q.push(u);
-            }
+    std::vector<Score> scores(candidates.size());
+    for (Score& s : scores) {
+        s.binCount.assign(bins, 0);
+        s.binProb.assign(bins, 0.0);
+        s.binFreq.assign(bins, 0.0);
+    }
+    // Workers for the exact counter (estimators themselves run on the main thread)
+    std::unique_ptr<WorkStealingPool> pool;
+    if (threads > 1) pool = std::make_unique<WorkStealingPool>(threads);
+    int evaluated = 0, skipped = 0, largestCore = 0;
+    double exactSeconds = 0.0;
+    std::vector<double> trainFeatures, trainLabels;
+    for (const std::string& input : inputs) {
+        Graph graph = loadGraphFromJson(input);
+        State state(graph.numVertices);
+        apply_crown_decomposition(state, graph);
+        std::vector<int> core(state.possibleVertices.begin(), state.possibleVertices.end());
+        std::sort(core.begin(), core.end());
+
+        std::vector<double> freq;
+        int mvcSize = -1;
+        double mvcCount = 0.0;
+        auto tExact = std::chrono::steady_clock::now();
+        if (core.empty() || static_cast<int>(core.size()) > maxCore ||
+            !exact_inclusion_frequencies(graph, core, pool.get(), freq, mvcSize, mvcCount)) {
+            ++skipped;
+            continue;
         }
+        exactSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - tExact).count();
+        largestCore = std::max(largestCore, static_cast<int>(core.size()));
+        ++evaluated;
 
-        while (!q.empty()) {
-            int u = q.front();
-            q.pop();
-            for (int v : adj[u]) {
-                if (!possible.count(v)) continue;
-                if (pairU[u] == v) continue;
-                if (!ZR[v]) {
-                    ZR[v] = true;
-                    if (pairV[v] != -1) {
-                        int w = pairV[v];
-                        if (!ZL[w]) {
-                            ZL[w] = true;
-                            q.push(w);
-                        }
-                    }
-                }
-            }
+        if (!trainPath.empty()) {
+            // core and the feature rows are both in increasing vertex order
+            std::vector<int> activeVerts;
+            std::vector<double> features;
+            estimator::linearFeatures(state, graph, activeVerts, features);
+            trainFeatures.insert(trainFeatures.end(), features.begin(), features.end());
+            trainLabels.insert(trainLabels.end(), freq.begin(), freq.end());
+            continue;
         }
 
-        for (int u = 0; u < n; ++u) {
-            if (!possible.count(u)) continue;
-            bool inCL = !ZL[u];
-            bool inCR = ZR[u];
-            if (inCL && inCR) toInclude.push_back(u);
-            else if (!inCL && !inCR) toExclude.push_back(u);
+        for (std::size_t c = 0; c < candidates.size(); ++c) {
+            Score& s = scores[c];
+            std::vector<double> p = evaluate(candidates[c], state, graph, core, repeat, s);
+            ++s.instances;
+            s.vertices += static_cast<long long>(core.size());
+            for (std::size_t i = 0; i < core.size(); ++i) {
+                s.brierSum += (p[i] - freq[i]) * (p[i] - freq[i]);
+                int b = std::min(bins - 1, static_cast<int>(p[i] * bins));
+                ++s.binCount[b];
+                s.binProb[b] += p[i];
+                s.binFreq[b] += freq[i];
+                if (csv) csv << input << "," << core[i] << "," << candidates[c].label << "," << p[i] << "," << freq[i] << "\n";
+            }
+            double rho = spearman(p, freq);
+            if (!std::isnan(rho)) {
+                s.spearmanSum += rho;
+                ++s.spearmanInstances;
+            }
         }
     }
-};
-}
 
-static void apply_crown_decomposition(State& state, const Graph& graph) {
-    bool changed = true;
-    while (changed) {
-        changed = false;
-        if (state.possibleVertices.empty()) break;
+    if (!trainPath.empty()) {
+        estimator::LinearPriorModel model = fit_linear_prior(trainFeatures, trainLabels);
+        double brier = 0.0;
+        for (std::size_t i = 0; i < trainLabels.size(); ++i) {
+            double p = estimator::linearPriorOf(model, &trainFeatures[i * estimator::kLinearFeatures]);
+            brier += (p - trainLabels[i]) * (p - trainLabels[i]);
+        }
+        std::cout << "trained on " << evaluated << " instances (" << trainLabels.size() << " vertices), skipped="
+                  << skipped << " brier=" << std::setprecision(4) << brier / static_cast<double>(trainLabels.size())
+                  << "\nweights:";
+        for (double w : model.weights) std::cout << " " << w;
+        std::cout << "\n";
+        if (!estimator::saveLinearPriorModel(trainPath, model)) {
+            std::cerr << "Failed to write " << trainPath << std::endl;
+            return 1;
+        }
+        return 0;
+    }
 
-        NemhauserTrotter nt(graph.numVertices, graph.adjacencyList, state.possibleVertices);
-        std::vector<int> toInclude;
-        std::vector<int> toExclude;
-        nt.getKernelNodes(toInclude, toExclude);
+    std::cout << "instances=" << evaluated << " skipped=" << skipped << " (crown core empty or > " << maxCore
+              << " vertices) repeat=" << repeat << " largest_core=" << largestCore
+              << " exact_counting=" << std::setprecision(3) << exactSeconds << "s\n";
+    std::cout << std::left << std::setw(16) << "estimator" << std::right
+              << std::setw(10) << "brier" << std::setw(10) << "ece" << std::setw(10) << "spearman"
+              << std::setw(13) << "ns/call" << std::setw(13) << "ns/prior" << std::setw(13) << "allocs/call" << "\n";
+    std::cout << std::fixed;
+    for (std::size_t c = 0; c < candidates.size(); ++c) {
+        const Score& s = scores[c];
+        if (s.vertices == 0) continue;
+        double ece = 0.0;
+        for (int b = 0; b < bins; ++b) {
+            if (s.binCount[b] > 0) ece += std::fabs(s.binProb[b] - s.binFreq[b]) / static_cast<double>(s.vertices);
+        }
+        std::cout << std::left << std::setw(16) << candidates[c].label << std::right << std::setprecision(4)
+                  << std::setw(10) << s.brierSum / static_cast<double>(s.vertices)
+                  << std::setw(10) << ece;
+        if (s.spearmanInstances > 0) std::cout << std::setw(10) << s.spearmanSum / s.spearmanInstances;
+        else std::cout << std::setw(10) << "-";
+        std::cout << std::setprecision(0)
+                  << std::setw(13) << 1e9 * s.seconds / static_cast<double>(s.calls)
+                  << std::setw(13) << 1e9 * s.seconds / static_cast<double>(s.priors)
+                  << std::setprecision(1)
+                  << std::setw(13) << static_cast<double>(s.allocations) / static_cast<double>(s.calls) << "\n";
+    }
 
-        if (!toInclude.empty() || !toExclude.empty()) {
-            for (int u : toInclude) {
-                if (state.possibleVertices.count(u)) state.include(u);
-            }
-            for (int u : toExclude) {
-                if (state.possibleVertices.count(u)) state.exclude(u);
-            }
-            changed = true;
+    // Reliability table: mean predicted prior vs mean exact frequency per prior bin
+    std::cout << "\ncalibration (bin: count mean_prob/mean_freq)\n";
+    for (std::size_t c = 0; c < candidates.size(); ++c) {
+        const Score& s = scores[c];
+        if (s.vertices == 0) continue;
+        std::cout << std::left << std::setw(16) << candidates[c].label << std::right << std::setprecision(2);
+        for (int b = 0; b < bins; ++b) {
+            if (s.binCount[b] == 0) continue;
+            std::cout << "  [" << static_cast<double>(b) / bins << "," << static_cast<double>(b + 1) / bins << ") "
+                      << s.binCount[b] << " " << s.binProb[b] / s.binCount[b] << "/" << s.binFreq[b] / s.binCount[b];
         }
+        std::cout << "\n";
     }
-}
 
-int main(int argc, char** argv) {
-	std::string graphPath = "data/exact/inputs/graph_0000.json";
-	if (argc >= 2) {
-		graphPath = argv[1];
-	}
-
-	Graph graph = loadGraphFromJson(graphPath);
-	init_estimate_policy();
-
-    State coreState(graph.numVertices);
-    apply_crown_decomposition(coreState, graph);
-
-    std::unordered_set<int> crownCore = coreState.possibleVertices;
-
-    long long totalMvcCount = 0;
-    std::vector<long long> vertexInMvcCount;
-    int mvcSize = -1;
-    enumerate_all_mvc_bruteforce(graph, crownCore, totalMvcCount, vertexInMvcCount, mvcSize);
-
-	std::cout << "Graph: " << graphPath << "\n";
-	std::cout << "num_vertices=" << graph.numVertices << "\n";
-    std::cout << "crown_core_vertices=" << crownCore.size() << "\n";
-    if (crownCore.size() > 20) {
-        std::cout << "mvc_size=NA (crown_core_vertices > 20)\n";
-        std::cout << "total_mvc_count=NA (crown_core_vertices > 20)\n";
-    } else {
-        std::cout << "mvc_size=" << mvcSize << "\n";
-        std::cout << "total_mvc_count=" << totalMvcCount << "\n";
+    // Sequential stopping: trials (LP) / samples (Gibbs) used against the fixed budgets
+    std::vector<estimator::BudgetStats::Row> budgets = estimator::budgetStats.rows();
+    if (!budgets.empty()) std::cout << "\nadaptive budgets (calls early% used/budget saved)\n";
+    for (const estimator::BudgetStats::Row& r : budgets) {
+        std::cout << std::left << std::setw(16) << r.estimator << std::right << std::setprecision(1)
+                  << " " << r.calls << " " << 100.0 * r.earlyCalls / r.calls << "% "
+                  << static_cast<double>(r.used) / r.calls << "/" << static_cast<double>(r.budget) / r.calls
+                  << " " << 100.0 * (1.0 - static_cast<double>(r.used) / r.budget) << "%\n";
     }
-    std::cout << "vertex,prob_include,mvc_inclusion_count\n";
-
-	State state(graph.numVertices);
-    state.possibleVertices = crownCore; // run only on crown core vertices
-	for (int v = 0; v < graph.numVertices; ++v) {
-		if (!crownCore.count(v)) continue;
-		state.actionVertex = v;
-		double pInclude = treePolicy::estimatePolicy(state, graph, true);
-        long long c = (v < static_cast<int>(vertexInMvcCount.size())) ? vertexInMvcCount[v] : -1;
-        std::cout << v << "," << std::fixed << std::setprecision(6) << pInclude << "," << c << "\n";
-	}
-
-	return 0;
+    return 0;
 }